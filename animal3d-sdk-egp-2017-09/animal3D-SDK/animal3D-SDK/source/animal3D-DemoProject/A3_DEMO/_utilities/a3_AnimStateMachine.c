@@ -0,0 +1,351 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_AnimStateMachine.c
+	Implementation of animation state machine.
+*/
+
+#include "a3_AnimStateMachine.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+inline float a3animStateParam_internal(const a3_AnimStatePlayer *player, const a3_AnimState *state)
+{
+	const float param = player->param[state->paramIndex];
+	return param < 0.0f ? 0.0f : param > 1.0f ? 1.0f : param;
+}
+
+// set up controllers for a state, starting at phase
+inline void a3animStateEnter_internal(a3_ClipController *ctrl, const a3_AnimStateMachine *machine, const a3_AnimState *state, const float phase)
+{
+	const unsigned int clipCount = state->type == a3animState_clip ? 1 : 2;
+	unsigned int i;
+	for (i = 0; i < clipCount; ++i, ++ctrl)
+	{
+		a3clipCtrlSet(ctrl, machine->clipGroup, state->clipIndex[i]);
+		ctrl->playbackSpeed = state->playbackSpeed;
+		a3clipCtrlSetParam(ctrl, phase);
+	}
+}
+
+// advance controllers for a state
+inline void a3animStateUpdate_internal(a3_ClipController *ctrl, const a3_AnimState *state, const float dt)
+{
+	a3clipCtrlUpdate(ctrl, dt);
+	switch (state->type)
+	{
+		// blended clips stay at the same phase
+	case a3animState_blend:
+		a3clipCtrlSetParam(ctrl + 1, ctrl->clipParam);
+		break;
+		// layer runs on its own
+	case a3animState_layer:
+		a3clipCtrlUpdate(ctrl + 1, dt);
+		break;
+		// single clip: nothing else to advance
+	default:
+		break;
+	}
+}
+
+// interpolate clip's keys; additive clips are placed on the base pose
+//	(one scratch pose)
+inline int a3animEvaluateClip_internal(const a3_HierarchyPose *pose_out, const a3_ClipController *ctrl, const a3_AnimStateMachine *machine, a3_HierarchyPosePool *pool, const a3_HierarchyPoseFlag flag)
+{
+	const a3_HierarchyPoseGroup *poseGroup = machine->poseGroup;
+	const unsigned int nodeCount = poseGroup->hierarchy->numNodes;
+	const a3_HierarchyPose *scratch;
+
+	if (ctrl->clipGroup->clips[ctrl->clipIndex].poseMode == a3clipPose_absolute)
+	{
+		a3hierarchyPoseLERP(pose_out, poseGroup->pose + ctrl->frameIndex, poseGroup->pose + ctrl->nextIndex, 
+			ctrl->frameParam, nodeCount, flag);
+		return 1;
+	}
+	if (a3hierarchyPosePoolAcquire(pool, &scratch) < 0)
+		return -1;
+	a3hierarchyPoseLERP(scratch, poseGroup->pose + ctrl->frameIndex, poseGroup->pose + ctrl->nextIndex, 
+		ctrl->frameParam, nodeCount, flag);
+	a3hierarchyPoseConcat(pose_out, poseGroup->pose + machine->basePoseIndex, scratch, nodeCount, flag);
+	a3hierarchyPosePoolReturn(pool, scratch);
+	return 1;
+}
+
+// evaluate a state (up to three scratch poses)
+inline int a3animEvaluateState_internal(const a3_HierarchyPose *pose_out, const a3_ClipController *ctrl, const a3_AnimStatePlayer *player, const a3_AnimState *state, a3_HierarchyPosePool *pool, const a3_HierarchyPoseFlag flag)
+{
+	const a3_AnimStateMachine *machine = player->machine;
+	const a3_HierarchyPoseGroup *poseGroup = machine->poseGroup;
+	const unsigned int nodeCount = poseGroup->hierarchy->numNodes;
+	const a3_HierarchyPose *scratch0, *scratch1;
+	int result = -1;
+
+	if (state->type == a3animState_clip)
+		return a3animEvaluateClip_internal(pose_out, ctrl, machine, pool, flag);
+
+	if (a3hierarchyPosePoolAcquire(pool, &scratch0) < 0)
+		return -1;
+	if (a3hierarchyPosePoolAcquire(pool, &scratch1) >= 0)
+	{
+		if (a3animEvaluateClip_internal(scratch0, ctrl, machine, pool, flag) > 0)
+		{
+			if (state->type == a3animState_blend)
+			{
+				if (a3animEvaluateClip_internal(scratch1, ctrl + 1, machine, pool, flag) > 0)
+				{
+					a3hierarchyPoseLERP(pose_out, scratch0, scratch1, a3animStateParam_internal(player, state), nodeCount, flag);
+					result = 1;
+				}
+			}
+			else
+			{
+				// layer keys are used as deltas, without the base pose
+				a3hierarchyPoseLERP(scratch1, poseGroup->pose + ctrl[1].frameIndex, poseGroup->pose + ctrl[1].nextIndex, 
+					ctrl[1].frameParam, nodeCount, flag);
+				a3hierarchyPoseAddLayer(pose_out, scratch0, scratch1, a3animStateParam_internal(player, state), nodeCount, flag);
+				result = 1;
+			}
+		}
+		a3hierarchyPosePoolReturn(pool, scratch1);
+	}
+	a3hierarchyPosePoolReturn(pool, scratch0);
+	return result;
+}
+
+inline int a3animStateValid_internal(const a3_AnimStateMachine *machine, const a3_AnimState *state)
+{
+	const unsigned int clipCount = state->type == a3animState_clip ? 1 : 2;
+	unsigned int i;
+	for (i = 0; i < clipCount; ++i)
+		if (state->clipIndex[i] >= machine->clipGroup->clipCount)
+			return 0;
+	return (state->type == a3animState_clip || state->paramIndex < a3animStatePlayer_paramMax);
+}
+
+
+//-----------------------------------------------------------------------------
+
+// create state machine
+extern inline int a3animStateMachineCreate(a3_AnimStateMachine *machine_out, const a3_ClipGroup *clipGroup, const a3_HierarchyPoseGroup *poseGroup, const unsigned int basePoseIndex, const unsigned int stateCount, const unsigned int transitionCount)
+{
+	if (machine_out && !machine_out->state && clipGroup && clipGroup->clips && poseGroup && poseGroup->hierarchy && 
+		basePoseIndex < poseGroup->poseCount && stateCount)
+	{
+		const unsigned int bytes = stateCount * sizeof(a3_AnimState) + transitionCount * sizeof(a3_AnimTransition);
+		machine_out->clipGroup = clipGroup;
+		machine_out->poseGroup = poseGroup;
+		machine_out->basePoseIndex = basePoseIndex;
+		machine_out->state = (a3_AnimState *)malloc(bytes);
+		memset(machine_out->state, 0, bytes);
+		machine_out->transition = transitionCount ? (a3_AnimTransition *)(machine_out->state + stateCount) : 0;
+		machine_out->stateCount = stateCount;
+		machine_out->transitionCount = transitionCount;
+		return stateCount;
+	}
+	return -1;
+}
+
+// release state machine
+extern inline int a3animStateMachineRelease(a3_AnimStateMachine *machine)
+{
+	if (machine && machine->state)
+	{
+		free(machine->state);
+		memset(machine, 0, sizeof(a3_AnimStateMachine));
+		return 1;
+	}
+	return -1;
+}
+
+// initialize state
+extern inline int a3animStateInit(const a3_AnimStateMachine *machine, const unsigned int stateIndex, const char name[32], const a3_AnimStateType type, const unsigned int clipIndex0, const unsigned int clipIndex1, const unsigned int paramIndex, const float playbackSpeed)
+{
+	if (machine && machine->state && stateIndex < machine->stateCount)
+	{
+		a3_AnimState *state = machine->state + stateIndex;
+		a3_AnimState tmp[1];
+
+		tmp->type = type;
+		tmp->clipIndex[0] = clipIndex0;
+		tmp->clipIndex[1] = clipIndex1;
+		tmp->paramIndex = paramIndex;
+		if (!a3animStateValid_internal(machine, tmp))
+			return -1;
+
+		strncpy(state->name, name, sizeof(state->name));
+		state->type = type;
+		state->clipIndex[0] = clipIndex0;
+		state->clipIndex[1] = type == a3animState_clip ? clipIndex0 : clipIndex1;
+		state->paramIndex = type == a3animState_clip ? 0 : paramIndex;
+		state->playbackSpeed = playbackSpeed;
+		return stateIndex;
+	}
+	return -1;
+}
+
+// initialize transition
+extern inline int a3animTransitionInit(const a3_AnimStateMachine *machine, const unsigned int transitionIndex, const int fromState, const unsigned int toState, const a3_AnimCondition condition, const unsigned int paramIndex, const float threshold, const float exitPhase, const float fadeDuration, const int syncPhase)
+{
+	if (machine && machine->transition && transitionIndex < machine->transitionCount && 
+		fromState < (int)machine->stateCount && toState < machine->stateCount && paramIndex < a3animStatePlayer_paramMax)
+	{
+		a3_AnimTransition *transition = machine->transition + transitionIndex;
+		transition->fromState = fromState;
+		transition->toState = toState;
+		transition->condition = condition;
+		transition->paramIndex = paramIndex;
+		transition->threshold = threshold;
+		transition->exitPhase = exitPhase;
+		transition->fadeDuration = fadeDuration > 0.0f ? fadeDuration : 0.0f;
+		transition->syncPhase = syncPhase;
+		return transitionIndex;
+	}
+	return -1;
+}
+
+
+// start player
+extern inline int a3animStatePlayerInit(a3_AnimStatePlayer *player_out, const a3_AnimStateMachine *machine, const unsigned int stateIndex)
+{
+	if (player_out && machine && machine->state && stateIndex < machine->stateCount)
+	{
+		memset(player_out, 0, sizeof(a3_AnimStatePlayer));
+		player_out->machine = machine;
+		player_out->stateIndex = player_out->prevStateIndex = stateIndex;
+		a3animStateEnter_internal(player_out->ctrl, machine, machine->state + stateIndex, 0.0f);
+		return stateIndex;
+	}
+	return -1;
+}
+
+// set player parameter
+extern inline int a3animStatePlayerSetParam(a3_AnimStatePlayer *player, const unsigned int paramIndex, const float value)
+{
+	if (player && paramIndex < a3animStatePlayer_paramMax)
+	{
+		player->param[paramIndex] = value;
+		return paramIndex;
+	}
+	return -1;
+}
+
+// update player
+extern inline int a3animStatePlayerUpdate(a3_AnimStatePlayer *player, const float dt)
+{
+	if (player && player->machine)
+	{
+		const a3_AnimStateMachine *machine = player->machine;
+		const a3_AnimTransition *transition = machine->transition, *const end = transition + machine->transitionCount;
+		float param, phase;
+		int pass;
+
+		// advance current state and the one fading out
+		a3animStateUpdate_internal(player->ctrl, machine->state + player->stateIndex, dt);
+		if (player->fadeDuration > 0.0f)
+		{
+			a3animStateUpdate_internal(player->prevCtrl, machine->state + player->prevStateIndex, dt);
+			player->fadeTime += dt;
+			if (player->fadeTime >= player->fadeDuration)
+				player->fadeDuration = 0.0f;
+		}
+
+		// first passing transition wins
+		phase = player->ctrl->clipParam;
+		for (; transition < end; ++transition)
+		{
+			if (transition->toState == player->stateIndex || 
+				(transition->fromState >= 0 && (unsigned int)transition->fromState != player->stateIndex) || 
+				phase < transition->exitPhase)
+				continue;
+
+			param = player->param[transition->paramIndex];
+			switch (transition->condition)
+			{
+			case a3animCondition_greater:
+				pass = param > transition->threshold;
+				break;
+			case a3animCondition_less:
+				pass = param < transition->threshold;
+				break;
+			default:
+				pass = 1;
+				break;
+			}
+			if (!pass)
+				continue;
+
+			// fade out from current state; a fade already in progress 
+			//	is dropped in favor of the newer one
+			if (transition->fadeDuration > 0.0f)
+			{
+				player->prevStateIndex = player->stateIndex;
+				memcpy(player->prevCtrl, player->ctrl, sizeof(player->ctrl));
+				player->fadeTime = 0.0f;
+			}
+			player->fadeDuration = transition->fadeDuration;
+			player->stateIndex = transition->toState;
+			a3animStateEnter_internal(player->ctrl, machine, machine->state + player->stateIndex, 
+				transition->syncPhase ? phase : 0.0f);
+			break;
+		}
+		return player->stateIndex;
+	}
+	return -1;
+}
+
+// evaluate player
+extern inline int a3animStatePlayerEvaluate(const a3_AnimStatePlayer *player, a3_HierarchyPosePool *pool, const a3_HierarchyPose *pose_out, const a3_HierarchyPoseFlag flag)
+{
+	if (player && player->machine && pool && pose_out && pose_out->nodePose)
+	{
+		const a3_AnimStateMachine *machine = player->machine;
+		const unsigned int nodeCount = machine->poseGroup->hierarchy->numNodes;
+		const a3_HierarchyPose *scratch0, *scratch1;
+		int result = -1;
+
+		if (player->fadeDuration <= 0.0f)
+			return a3animEvaluateState_internal(pose_out, player->ctrl, player, machine->state + player->stateIndex, pool, flag) > 0 ? (int)nodeCount : -1;
+
+		// crossfade previous into current
+		if (a3hierarchyPosePoolAcquire(pool, &scratch0) < 0)
+			return -1;
+		if (a3hierarchyPosePoolAcquire(pool, &scratch1) >= 0)
+		{
+			if (a3animEvaluateState_internal(scratch0, player->prevCtrl, player, machine->state + player->prevStateIndex, pool, flag) > 0 && 
+				a3animEvaluateState_internal(scratch1, player->ctrl, player, machine->state + player->stateIndex, pool, flag) > 0)
+			{
+				a3hierarchyPoseLERP(pose_out, scratch0, scratch1, player->fadeTime / player->fadeDuration, nodeCount, flag);
+				result = nodeCount;
+			}
+			a3hierarchyPosePoolReturn(pool, scratch1);
+		}
+		a3hierarchyPosePoolReturn(pool, scratch0);
+		return result;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
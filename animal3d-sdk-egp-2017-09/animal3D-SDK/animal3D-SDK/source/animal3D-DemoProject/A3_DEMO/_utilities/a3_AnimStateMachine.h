@@ -0,0 +1,185 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_AnimStateMachine.h
+	Animation state machine: states play a clip, a blend of two clips or a 
+		clip with an additive layer; transitions fire on parameter tests and 
+		crossfade over time. The machine is a shared description; each 
+		character only keeps a small fixed-size player, and intermediate 
+		poses come from a shared scratch pool during evaluation.
+*/
+
+#ifndef __ANIMAL3D_ANIMSTATEMACHINE_H
+#define __ANIMAL3D_ANIMSTATEMACHINE_H
+
+
+#include "a3_HierarchyState.h"
+#include "a3_ClipControl.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_AnimState				a3_AnimState;
+	typedef struct a3_AnimTransition		a3_AnimTransition;
+	typedef struct a3_AnimStateMachine		a3_AnimStateMachine;
+	typedef struct a3_AnimStatePlayer		a3_AnimStatePlayer;
+	typedef enum a3_AnimStateMachineMaxCounts	a3_AnimStateMachineMaxCounts;
+	typedef enum a3_AnimStateType			a3_AnimStateType;
+	typedef enum a3_AnimCondition			a3_AnimCondition;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fixed limits so that players never allocate
+	enum a3_AnimStateMachineMaxCounts
+	{
+		a3animState_clipMax = 2,		// clips played by one state
+		a3animStatePlayer_paramMax = 4,	// parameters per player
+	};
+
+	// what a state plays
+	enum a3_AnimStateType
+	{
+		a3animState_clip,		// single clip
+		a3animState_blend,		// clip 0 to clip 1 by param, phase-locked to clip 0
+		a3animState_layer,		// clip 0 plus additive clip 1 weighted by param
+	};
+
+	// test applied to a parameter to fire a transition
+	enum a3_AnimCondition
+	{
+		a3animCondition_always,
+		a3animCondition_greater,
+		a3animCondition_less,
+	};
+
+	// single state
+	struct a3_AnimState
+	{
+		char name[32];
+		a3_AnimStateType type;
+		unsigned int clipIndex[a3animState_clipMax];
+
+		// parameter used as blend param or layer weight
+		unsigned int paramIndex;
+
+		// playback speed for clips of this state
+		float playbackSpeed;
+	};
+
+	// single transition; earlier transitions take priority
+	struct a3_AnimTransition
+	{
+		// source state (negative: any other state) and destination
+		int fromState;
+		unsigned int toState;
+
+		// condition: param (compared to) threshold
+		a3_AnimCondition condition;
+		unsigned int paramIndex;
+		float threshold;
+
+		// source clip phase that must be reached before leaving 
+		//	(zero to leave any time)
+		float exitPhase;
+
+		// crossfade time (zero to cut)
+		float fadeDuration;
+
+		// start destination at source's phase instead of the beginning
+		int syncPhase;
+	};
+
+	// shared description
+	struct a3_AnimStateMachine
+	{
+		const a3_ClipGroup *clipGroup;
+		const a3_HierarchyPoseGroup *poseGroup;
+
+		// pose concatenated under additive clips that are played alone
+		unsigned int basePoseIndex;
+
+		a3_AnimState *state;
+		a3_AnimTransition *transition;
+		unsigned int stateCount, transitionCount;
+	};
+
+	// per-character playback state (fixed size)
+	struct a3_AnimStatePlayer
+	{
+		const a3_AnimStateMachine *machine;
+
+		// current state and the one being faded out (if fading)
+		unsigned int stateIndex, prevStateIndex;
+		a3_ClipController ctrl[a3animState_clipMax], prevCtrl[a3animState_clipMax];
+
+		// crossfade progress; no fade if duration is zero
+		float fadeTime, fadeDuration;
+
+		float param[a3animStatePlayer_paramMax];
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// allocate state machine description
+	inline int a3animStateMachineCreate(a3_AnimStateMachine *machine_out, const a3_ClipGroup *clipGroup, const a3_HierarchyPoseGroup *poseGroup, const unsigned int basePoseIndex, const unsigned int stateCount, const unsigned int transitionCount);
+
+	// release state machine description
+	inline int a3animStateMachineRelease(a3_AnimStateMachine *machine);
+
+	// initialize state (clipIndex1 and paramIndex are ignored by clip states)
+	inline int a3animStateInit(const a3_AnimStateMachine *machine, const unsigned int stateIndex, const char name[32], const a3_AnimStateType type, const unsigned int clipIndex0, const unsigned int clipIndex1, const unsigned int paramIndex, const float playbackSpeed);
+
+	// initialize transition
+	inline int a3animTransitionInit(const a3_AnimStateMachine *machine, const unsigned int transitionIndex, const int fromState, const unsigned int toState, const a3_AnimCondition condition, const unsigned int paramIndex, const float threshold, const float exitPhase, const float fadeDuration, const int syncPhase);
+
+
+	// start player in state
+	inline int a3animStatePlayerInit(a3_AnimStatePlayer *player_out, const a3_AnimStateMachine *machine, const unsigned int stateIndex);
+
+	// set player parameter
+	inline int a3animStatePlayerSetParam(a3_AnimStatePlayer *player, const unsigned int paramIndex, const float value);
+
+	// advance clips and fade, then take the first transition that passes
+	// returns current state index
+	inline int a3animStatePlayerUpdate(a3_AnimStatePlayer *player, const float dt);
+
+	// evaluate player's pose; needs up to five scratch poses from the pool 
+	//	while crossfading and returns them all before returning
+	// returns node count, or -1 if invalid or the pool ran out
+	inline int a3animStatePlayerEvaluate(const a3_AnimStatePlayer *player, a3_HierarchyPosePool *pool, const a3_HierarchyPose *pose_out, const a3_HierarchyPoseFlag flag);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_ANIMSTATEMACHINE_H
@@ -0,0 +1,303 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_BoneDisplay.c
+	Implementation of hierarchy display transforms.
+*/
+
+#include "a3_BoneDisplay.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if (defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1) || defined __SSE__)
+#define A3_BONEDISPLAY_SSE
+#include <xmmintrin.h>
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef A3_BONEDISPLAY_SSE
+
+// cross product of xyz (w of inputs must be zero)
+inline __m128 a3boneDisplayCross_internal(const __m128 a, const __m128 b)
+{
+	return _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))));
+}
+
+// normalize xyz (w must be zero); zero stays zero
+inline __m128 a3boneDisplayNormalize_internal(const __m128 v)
+{
+	__m128 s = _mm_mul_ps(v, v);
+	s = _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+	s = _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_and_ps(_mm_cmpgt_ps(s, _mm_setzero_ps()), _mm_mul_ps(v, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(s))));
+}
+
+// bone frame from parent and joint positions
+inline void a3boneDisplayBone_internal(p3mat4 *bone_out, const p3mat4 *node, const p3mat4 *parent)
+{
+	const __m128 origin = _mm_loadu_ps(parent->v3.v);
+	const __m128 dir = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(node->v3.v), origin), _mm_set_ps(0.0f, 1.0f, 1.0f, 1.0f));
+	const __m128 up = (node->v3.y != parent->v3.y) ? _mm_set_ps(0.0f, 1.0f, 0.0f, 0.0f) : _mm_set_ps(0.0f, 0.0f, 1.0f, 0.0f);
+	const __m128 side = a3boneDisplayNormalize_internal(a3boneDisplayCross_internal(up, dir));
+	_mm_storeu_ps(bone_out->v0.v, side);
+	_mm_storeu_ps(bone_out->v1.v, a3boneDisplayNormalize_internal(a3boneDisplayCross_internal(dir, side)));
+	_mm_storeu_ps(bone_out->v2.v, dir);
+	_mm_storeu_ps(bone_out->v3.v, origin);
+}
+
+// joint with scaled basis
+inline void a3boneDisplayAxes_internal(p3mat4 *axes_out, const p3mat4 *node, const float scale)
+{
+	const __m128 s = _mm_set1_ps(scale);
+	_mm_storeu_ps(axes_out->v0.v, _mm_mul_ps(s, _mm_loadu_ps(node->v0.v)));
+	_mm_storeu_ps(axes_out->v1.v, _mm_mul_ps(s, _mm_loadu_ps(node->v1.v)));
+	_mm_storeu_ps(axes_out->v2.v, _mm_mul_ps(s, _mm_loadu_ps(node->v2.v)));
+	axes_out->v3 = node->v3;
+}
+
+#else	// !A3_BONEDISPLAY_SSE
+
+// unit cross product of xyz; zero stays zero
+inline void a3boneDisplayCross_internal(float *v_out, const float *a, const float *b)
+{
+	float lenSq;
+	v_out[0] = a[1] * b[2] - a[2] * b[1];
+	v_out[1] = a[2] * b[0] - a[0] * b[2];
+	v_out[2] = a[0] * b[1] - a[1] * b[0];
+	v_out[3] = 0.0f;
+	lenSq = v_out[0] * v_out[0] + v_out[1] * v_out[1] + v_out[2] * v_out[2];
+	if (lenSq > 0.0f)
+	{
+		lenSq = 1.0f / sqrtf(lenSq);
+		v_out[0] *= lenSq;
+		v_out[1] *= lenSq;
+		v_out[2] *= lenSq;
+	}
+}
+
+inline void a3boneDisplayBone_internal(p3mat4 *bone_out, const p3mat4 *node, const p3mat4 *parent)
+{
+	bone_out->v3 = parent->v3;
+	p3real4Diff(bone_out->v2.v, node->v3.v, parent->v3.v);
+	bone_out->v2.w = 0.0f;
+	a3boneDisplayCross_internal(bone_out->v0.v, (bone_out->y2 != 0.0f ? p3zVec3.v : p3yVec3.v), bone_out->v2.v);
+	a3boneDisplayCross_internal(bone_out->v1.v, bone_out->v2.v, bone_out->v0.v);
+}
+
+inline void a3boneDisplayAxes_internal(p3mat4 *axes_out, const p3mat4 *node, const float scale)
+{
+	p3real4ProductS(axes_out->v0.v, node->v0.v, scale);
+	p3real4ProductS(axes_out->v1.v, node->v1.v, scale);
+	p3real4ProductS(axes_out->v2.v, node->v2.v, scale);
+	axes_out->v3 = node->v3;
+}
+
+#endif	// A3_BONEDISPLAY_SSE
+
+// project translation of each matrix: xyz become NDC, w stays clip w
+inline void a3boneDisplayProject_internal(p3vec4 *projected_out, const p3mat4 *transform, const p3mat4 *mvp, const unsigned int count)
+{
+	unsigned int i = 0;
+	float wInv;
+
+#ifdef A3_BONEDISPLAY_SSE
+	// four joints at a time: positions gathered into SoA form
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 px, py, pz, cx, cy, cz, cw, wInv4;
+
+#define a3boneDisplayRow_internal(r)	_mm_add_ps(\
+	_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(mvp->m[0][r])), _mm_mul_ps(py, _mm_set1_ps(mvp->m[1][r]))),\
+	_mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(mvp->m[2][r])), _mm_set1_ps(mvp->m[3][r])))
+
+	for (; i + 4 <= count; i += 4, transform += 4, projected_out += 4)
+	{
+		px = _mm_set_ps(transform[3].v3.x, transform[2].v3.x, transform[1].v3.x, transform[0].v3.x);
+		py = _mm_set_ps(transform[3].v3.y, transform[2].v3.y, transform[1].v3.y, transform[0].v3.y);
+		pz = _mm_set_ps(transform[3].v3.z, transform[2].v3.z, transform[1].v3.z, transform[0].v3.z);
+		cx = a3boneDisplayRow_internal(0);
+		cy = a3boneDisplayRow_internal(1);
+		cz = a3boneDisplayRow_internal(2);
+		cw = a3boneDisplayRow_internal(3);
+		wInv4 = _mm_div_ps(one, cw);
+		cx = _mm_mul_ps(cx, wInv4);
+		cy = _mm_mul_ps(cy, wInv4);
+		cz = _mm_mul_ps(cz, wInv4);
+		_MM_TRANSPOSE4_PS(cx, cy, cz, cw);
+		_mm_storeu_ps(projected_out[0].v, cx);
+		_mm_storeu_ps(projected_out[1].v, cy);
+		_mm_storeu_ps(projected_out[2].v, cz);
+		_mm_storeu_ps(projected_out[3].v, cw);
+	}
+
+#undef a3boneDisplayRow_internal
+#endif	// A3_BONEDISPLAY_SSE
+
+	for (; i < count; ++i, ++transform, ++projected_out)
+	{
+		p3real4Real4x4Product(projected_out->v, mvp->m, transform->v3.v);
+		wInv = 1.0f / projected_out->w;
+		projected_out->x *= wInv;
+		projected_out->y *= wInv;
+		projected_out->z *= wInv;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern inline int a3boneDisplayCreate(a3_BoneDisplay *display_out, const a3_Hierarchy *hierarchy, const float axesScale)
+{
+	if (display_out && hierarchy && !display_out->hierarchy && hierarchy->numNodes)
+	{
+		const unsigned int count = hierarchy->numNodes;
+		const unsigned int size = 3 * count * sizeof(p3mat4) + count * sizeof(p3vec4) + count;
+		display_out->boneTransform = (p3mat4 *)malloc(size);
+		display_out->axesTransform = display_out->boneTransform + count;
+		display_out->sourceTransform = display_out->axesTransform + count;
+		display_out->jointProjected = (p3vec4 *)(display_out->sourceTransform + count);
+		display_out->changed = (unsigned char *)(display_out->jointProjected + count);
+		memset(display_out->boneTransform, 0, size);
+
+		display_out->hierarchy = hierarchy;
+		display_out->axesScale = axesScale;
+		display_out->invalid = 1;
+		return count;
+	}
+	return -1;
+}
+
+extern inline int a3boneDisplayRelease(a3_BoneDisplay *display)
+{
+	if (display && display->hierarchy)
+	{
+		free(display->boneTransform);
+		display->boneTransform = display->axesTransform = display->sourceTransform = 0;
+		display->jointProjected = 0;
+		display->changed = 0;
+		display->hierarchy = 0;
+		return 1;
+	}
+	return -1;
+}
+
+extern inline int a3boneDisplayInvalidate(a3_BoneDisplay *display)
+{
+	if (display && display->hierarchy)
+	{
+		display->invalid = 1;
+		return 1;
+	}
+	return -1;
+}
+
+extern inline int a3boneDisplayUpdate(a3_BoneDisplay *display, const a3_HierarchyTransform *objectSpace)
+{
+	if (display && display->hierarchy && objectSpace && objectSpace->transform)
+	{
+		const a3_HierarchyNode *node = display->hierarchy->nodes;
+		const p3mat4 *source = objectSpace->transform;
+		const unsigned int count = display->hierarchy->numNodes;
+		unsigned int i, result = 0;
+		int parentIndex;
+
+		// find what moved; joint axes only depend on the joint itself
+		for (i = 0; i < count; ++i)
+		{
+			display->changed[i] = display->invalid || memcmp(source + i, display->sourceTransform + i, sizeof(p3mat4));
+			if (display->changed[i])
+			{
+				display->sourceTransform[i] = source[i];
+				a3boneDisplayAxes_internal(display->axesTransform + i, source + i, display->axesScale);
+			}
+		}
+		display->invalid = 0;
+
+		// bones depend on the joint and its parent
+		for (i = 0; i < count; ++i)
+		{
+			parentIndex = node[i].parentIndex;
+			if (parentIndex >= 0)
+			{
+				if (display->changed[i] || display->changed[parentIndex])
+				{
+					a3boneDisplayBone_internal(display->boneTransform + i, source + i, source + parentIndex);
+					++result;
+				}
+			}
+			else if (display->changed[i])
+				++result;
+		}
+		return result;
+	}
+	return -1;
+}
+
+extern inline int a3boneDisplayProject(a3_BoneDisplay *display, const p3mat4 *modelViewProjection)
+{
+	if (display && display->hierarchy && modelViewProjection)
+	{
+		a3boneDisplayProject_internal(display->jointProjected, display->sourceTransform, modelViewProjection, display->hierarchy->numNodes);
+		return display->hierarchy->numNodes;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern inline int a3boneDisplayProjectJoints(p3vec4 *projected_out, const a3_HierarchyTransform *objectSpaceList, const p3mat4 *modelViewProjectionList, const unsigned int stateCount, const unsigned int nodeCount)
+{
+	if (projected_out && objectSpaceList && modelViewProjectionList)
+	{
+		unsigned int i;
+		for (i = 0; i < stateCount; ++i)
+			if (objectSpaceList[i].transform)
+				a3boneDisplayProject_internal(projected_out + i * nodeCount, objectSpaceList[i].transform, modelViewProjectionList + i, nodeCount);
+			else
+				return -1;
+		return (stateCount * nodeCount);
+	}
+	return -1;
+}
+
+extern inline int a3boneDisplayProjectedToScreen(float *screen_out, const p3vec4 *projected, const unsigned int count, const float viewportWidth, const float viewportHeight)
+{
+	if (screen_out && projected)
+	{
+		const float hw = 0.5f * viewportWidth, hh = 0.5f * viewportHeight;
+		unsigned int i;
+		for (i = 0; i < count; ++i, screen_out += 2)
+		{
+			screen_out[0] = (projected[i].x + 1.0f) * hw;
+			screen_out[1] = (projected[i].y + 1.0f) * hh;
+		}
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_BoneDisplay.h
+	Display transforms for drawing a hierarchy (bone frames linking each 
+		joint to its parent, scaled joint axes). Computed from object-space 
+		transforms outside of rendering and only redone for joints that moved.
+*/
+
+#ifndef __ANIMAL3D_BONEDISPLAY_H
+#define __ANIMAL3D_BONEDISPLAY_H
+
+
+#include "a3_HierarchyState.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_BoneDisplay	a3_BoneDisplay;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// display transforms for one hierarchy state
+	struct a3_BoneDisplay
+	{
+		// hierarchy being displayed
+		const a3_Hierarchy *hierarchy;
+
+		// bone frames: origin at parent, Z axis reaching to the joint 
+		//	(zero matrix for roots, so nothing is drawn)
+		p3mat4 *boneTransform;
+
+		// joint transforms with basis scaled down for axes overlay
+		p3mat4 *axesTransform;
+
+		// object-space transforms the above were built from
+		p3mat4 *sourceTransform;
+
+		// joint positions projected by the last call to project: xyz in 
+		//	NDC, w is clip-space w (zero or less means behind the viewer)
+		p3vec4 *jointProjected;
+
+		// per-node flag for nodes that changed in the last update
+		unsigned char *changed;
+
+		// scale applied to axes
+		float axesScale;
+
+		// set if cached source is meaningless and everything must be redone
+		int invalid;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create display transforms for hierarchy
+	inline int a3boneDisplayCreate(a3_BoneDisplay *display_out, const a3_Hierarchy *hierarchy, const float axesScale);
+
+	// release display transforms
+	inline int a3boneDisplayRelease(a3_BoneDisplay *display);
+
+	// force full rebuild on next update
+	inline int a3boneDisplayInvalidate(a3_BoneDisplay *display);
+
+	// rebuild display transforms for nodes whose object-space transform 
+	//	(or parent's) changed since the last update
+	//	return: number of nodes rebuilt (zero if nothing moved)
+	//	return: -1 if invalid params
+	inline int a3boneDisplayUpdate(a3_BoneDisplay *display, const a3_HierarchyTransform *objectSpace);
+
+	// project joints of the last update with a model-view-projection matrix; 
+	//	results are kept in the display for labels, picking and culling
+	inline int a3boneDisplayProject(a3_BoneDisplay *display, const p3mat4 *modelViewProjection);
+
+
+//-----------------------------------------------------------------------------
+
+	// project joint positions of many states in one pass: state i uses 
+	//	matrix i, and its results start at (i * nodeCount); output layout is 
+	//	the same as a3_BoneDisplay's projected joints
+	//	return: number of joints projected, -1 if invalid params
+	inline int a3boneDisplayProjectJoints(p3vec4 *projected_out, const a3_HierarchyTransform *objectSpaceList, const p3mat4 *modelViewProjectionList, const unsigned int stateCount, const unsigned int nodeCount);
+
+	// convert projected joints to window coordinates (origin bottom-left), 
+	//	stored as two floats per joint
+	inline int a3boneDisplayProjectedToScreen(float *screen_out, const p3vec4 *projected, const unsigned int count, const float viewportWidth, const float viewportHeight);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_BONEDISPLAY_H
@@ -26,6 +26,27 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// root displacement within one cycle at local clip time
+inline void a3clipSampleRootMotionLocal_internal(const a3_Clip *clip, p3vec4 *displacement_out, const float localTime)
+{
+	unsigned int frame = (unsigned int)(localTime * clip->frameDurationInv);
+	float param;
+	const p3vec4 *d0, *d1;
+	if (frame >= clip->count)
+		frame = clip->count - 1;
+	param = (localTime - (float)frame * clip->frameDuration) * clip->frameDurationInv;
+	d0 = clip->rootMotion + frame;
+	d1 = d0 + 1;
+	displacement_out->x = d0->x + (d1->x - d0->x) * param;
+	displacement_out->y = d0->y + (d1->y - d0->y) * param;
+	displacement_out->z = d0->z + (d1->z - d0->z) * param;
+	displacement_out->w = 0.0f;
+}
 
 
 //-----------------------------------------------------------------------------
@@ -50,6 +71,9 @@ extern inline int a3clipReleaseGroup(a3_ClipGroup *clipGroup)
 	if (clipGroup && clipGroup->clips)
 	{
 		const unsigned int clipCount = clipGroup->clipCount;
+		unsigned int i;
+		for (i = 0; i < clipCount; ++i)
+			free(clipGroup->clips[i].rootMotion);
 		free(clipGroup->clips);
 		clipGroup->clips = 0;
 		clipGroup->clipCount = 0;
@@ -89,11 +113,126 @@ extern inline int a3clipInit(const a3_ClipGroup *clipGroup, const unsigned int c
 			clip->clipDurationInv = 1.0f / clip->clipDuration;
 			clip->frameDurationInv = 1.0f / clip->frameDuration;
 		}
+		clip->poseMode = a3clipPose_additive;
+		free(clip->rootMotion);
+		clip->rootMotion = 0;
+		return clipIndex;
+	}
+	return -1;
+}
+
+// bake base pose into clip
+extern inline int a3clipBakeBasePose(const a3_ClipGroup *clipGroup, const unsigned int clipIndex, const a3_HierarchyPoseGroup *poseGroup, const unsigned int basePoseIndex, const a3_HierarchyPoseFlag flag)
+{
+	if (clipGroup && clipGroup->clips && clipIndex < clipGroup->clipCount && poseGroup && poseGroup->hierarchy && poseGroup->pose)
+	{
+		a3_Clip *clip = clipGroup->clips + clipIndex;
+		const a3_Clip *other;
+		const unsigned int nodeCount = poseGroup->hierarchy->numNodes;
+		unsigned int i;
+
+		// validate: additive, in range, base not a key of this clip
+		if (clip->poseMode != a3clipPose_additive || clip->last >= poseGroup->poseCount || 
+			basePoseIndex >= poseGroup->poseCount || (basePoseIndex >= clip->first && basePoseIndex <= clip->last))
+			return -1;
+
+		// keys shared with another clip would change under it (or be 
+		//	baked twice)
+		for (i = 0, other = clipGroup->clips; i < clipGroup->clipCount; ++i, ++other)
+			if (i != clipIndex && other->first <= clip->last && clip->first <= other->last)
+				return -1;
+
+		// base first so each key stays relative to the base's frame
+		for (i = clip->first; i <= clip->last; ++i)
+			a3hierarchyPoseConcat(poseGroup->pose + i, poseGroup->pose + basePoseIndex, poseGroup->pose + i, nodeCount, flag);
+
+		clip->poseMode = a3clipPose_absolute;
+		return clipIndex;
+	}
+	return -1;
+}
+
+// extract root motion from clip
+extern inline int a3clipExtractRootMotion(const a3_ClipGroup *clipGroup, const unsigned int clipIndex, const a3_HierarchyPoseGroup *poseGroup, const unsigned int rootIndex, const a3_ClipRootMotionAxis axis)
+{
+	if (clipGroup && clipGroup->clips && clipIndex < clipGroup->clipCount && poseGroup && poseGroup->hierarchy && poseGroup->pose && axis)
+	{
+		a3_Clip *clip = clipGroup->clips + clipIndex;
+		const a3_Clip *other;
+		const p3vec4 *rootFirst;
+		p3vec4 *rootMotion, *translation;
+		const float mx = (axis & a3clipRoot_x) ? 1.0f : 0.0f;
+		const float my = (axis & a3clipRoot_y) ? 1.0f : 0.0f;
+		const float mz = (axis & a3clipRoot_z) ? 1.0f : 0.0f;
+		const float cycleScale = clip->count > 1 ? (float)clip->count / (float)(clip->count - 1) : 0.0f;
+		unsigned int i;
+
+		// validate: not extracted, in range
+		if (clip->rootMotion || clip->last >= poseGroup->poseCount || rootIndex >= poseGroup->hierarchy->numNodes)
+			return -1;
+
+		// keys shared with an extracted clip would be moved twice
+		for (i = 0, other = clipGroup->clips; i < clipGroup->clipCount; ++i, ++other)
+			if (i != clipIndex && other->rootMotion && other->first <= clip->last && clip->first <= other->last)
+				return -1;
+
+		rootMotion = (p3vec4 *)malloc((clip->count + 1) * sizeof(p3vec4));
+
+		// displacement of each key from the first on the selected axes
+		rootFirst = &poseGroup->pose[clip->first].nodePose[rootIndex].translation;
+		for (i = 0; i < clip->count; ++i)
+		{
+			translation = &poseGroup->pose[clip->first + i].nodePose[rootIndex].translation;
+			rootMotion[i].x = (translation->x - rootFirst->x) * mx;
+			rootMotion[i].y = (translation->y - rootFirst->y) * my;
+			rootMotion[i].z = (translation->z - rootFirst->z) * mz;
+			rootMotion[i].w = 0.0f;
+		}
+
+		// whole cycle: last key's displacement covers all but the 
+		//	wrapping frame, which moves at the same average speed
+		rootMotion[clip->count].x = rootMotion[clip->count - 1].x * cycleScale;
+		rootMotion[clip->count].y = rootMotion[clip->count - 1].y * cycleScale;
+		rootMotion[clip->count].z = rootMotion[clip->count - 1].z * cycleScale;
+		rootMotion[clip->count].w = 0.0f;
+
+		// pin the root in the keys (first key is unchanged)
+		for (i = 1; i < clip->count; ++i)
+		{
+			translation = &poseGroup->pose[clip->first + i].nodePose[rootIndex].translation;
+			translation->x -= rootMotion[i].x;
+			translation->y -= rootMotion[i].y;
+			translation->z -= rootMotion[i].z;
+		}
+
+		clip->rootMotion = rootMotion;
 		return clipIndex;
 	}
 	return -1;
 }
 
+// sample clip root motion
+extern inline int a3clipSampleRootMotion(const a3_Clip *clip, p3vec4 *displacement_out, const float clipTime)
+{
+	if (clip && clip->rootMotion && displacement_out)
+	{
+		// whole cycles contribute the cycle displacement each
+		if (clip->clipDuration)
+		{
+			const float cycles = floorf(clipTime * clip->clipDurationInv);
+			const p3vec4 *cycle = clip->rootMotion + clip->count;
+			a3clipSampleRootMotionLocal_internal(clip, displacement_out, clipTime - cycles * clip->clipDuration);
+			displacement_out->x += cycle->x * cycles;
+			displacement_out->y += cycle->y * cycles;
+			displacement_out->z += cycle->z * cycles;
+		}
+		else
+			*displacement_out = *clip->rootMotion;
+		return 1;
+	}
+	return -1;
+}
+
 // set clip controller to clip
 //	(may want additional parameters)
 extern inline int a3clipCtrlSet(a3_ClipController *ctrl, const a3_ClipGroup *clipGroup, const unsigned int clipIndex)
@@ -111,11 +250,45 @@ extern inline int a3clipCtrlSet(a3_ClipController *ctrl, const a3_ClipGroup *cli
 		ctrl->frameIndex = clip->first;
 		ctrl->nextIndex = clip->first + (clip->count > 1);
 
+		ctrl->rootDelta.x = ctrl->rootDelta.y = ctrl->rootDelta.z = ctrl->rootDelta.w = 0.0f;
+
 		return clipIndex;
 	}
 	return -1;
 }
 
+// set clip controller time by param
+extern inline int a3clipCtrlSetParam(a3_ClipController *ctrl, const float clipParam)
+{
+	if (ctrl && ctrl->clipGroup)
+	{
+		const a3_Clip *clip = ctrl->clipGroup->clips + ctrl->clipIndex;
+		if (clip->clipDuration)
+		{
+			float param = clipParam - (float)(int)clipParam;
+			unsigned int frame;
+			if (param < 0.0f)
+				param += 1.0f;
+
+			// find frame containing time and remainder within it
+			ctrl->clipTime = param * clip->clipDuration;
+			frame = (unsigned int)(ctrl->clipTime * clip->frameDurationInv);
+			if (frame >= clip->count)
+				frame = clip->count - 1;
+			ctrl->frameTime = ctrl->clipTime - (float)frame * clip->frameDuration;
+			ctrl->frameIndex = clip->first + frame;
+			ctrl->nextIndex = (1 + frame) % clip->count + clip->first;
+			ctrl->frameParam = ctrl->frameTime * clip->frameDurationInv;
+			ctrl->clipParam = param;
+		}
+
+		// a jump in phase is not movement
+		ctrl->rootDelta.x = ctrl->rootDelta.y = ctrl->rootDelta.z = ctrl->rootDelta.w = 0.0f;
+		return ctrl->frameIndex;
+	}
+	return -1;
+}
+
 // update clip controller
 extern inline int a3clipCtrlUpdate(a3_ClipController *ctrl, const float dt)
 {
@@ -126,9 +299,11 @@ extern inline int a3clipCtrlUpdate(a3_ClipController *ctrl, const float dt)
 		//	add to clip time and calculate parameter
 		// if sample time exceeds sample duration, move to next frame
 		const a3_Clip *clip = ctrl->clipGroup->clips + ctrl->clipIndex;
+		ctrl->rootDelta.x = ctrl->rootDelta.y = ctrl->rootDelta.z = ctrl->rootDelta.w = 0.0f;
 		if (clip->clipDuration)
 		{
 			// accumulate time
+			const float clipTimePrev = ctrl->clipTime;
 			float dtFinal = dt * ctrl->playbackSpeed;
 			ctrl->frameTime += dtFinal;
 
@@ -158,6 +333,18 @@ extern inline int a3clipCtrlUpdate(a3_ClipController *ctrl, const float dt)
 
 			ctrl->clipTime = (ctrl->frameIndex - clip->first) * clip->frameDuration + ctrl->frameTime;
 			ctrl->clipParam = ctrl->clipTime * clip->clipDurationInv;
+
+			// root displacement: sample both ends; the end is sampled 
+			//	unwrapped so every cycle crossed in this update is counted
+			if (clip->rootMotion)
+			{
+				p3vec4 rootPrev, rootNext;
+				a3clipSampleRootMotionLocal_internal(clip, &rootPrev, clipTimePrev);
+				a3clipSampleRootMotion(clip, &rootNext, clipTimePrev + dtFinal);
+				ctrl->rootDelta.x = rootNext.x - rootPrev.x;
+				ctrl->rootDelta.y = rootNext.y - rootPrev.y;
+				ctrl->rootDelta.z = rootNext.z - rootPrev.z;
+			}
 		}
 		return ctrl->frameIndex;
 		
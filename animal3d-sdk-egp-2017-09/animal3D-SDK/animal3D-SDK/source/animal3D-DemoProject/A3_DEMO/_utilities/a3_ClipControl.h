@@ -27,6 +27,10 @@
 #define __ANIMAL3D_CLIPCONTROL_H
 
 
+// hierarchy poses (for baking base pose into clips)
+#include "a3_HierarchyState.h"
+
+
 //-----------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -36,11 +40,30 @@ extern "C"
 	typedef struct a3_Clip				a3_Clip;
 	typedef struct a3_ClipGroup			a3_ClipGroup;
 	typedef struct a3_ClipController	a3_ClipController;
+	typedef enum a3_ClipPoseMode		a3_ClipPoseMode;
+	typedef enum a3_ClipRootMotionAxis	a3_ClipRootMotionAxis;
 #endif	// __cplusplus
 
 
 //-----------------------------------------------------------------------------
 
+	// how a clip's key poses relate to the base pose
+	enum a3_ClipPoseMode
+	{
+		a3clipPose_additive,	// keys are deltas; concat base (or layer) at runtime
+		a3clipPose_absolute,	// base pose has been baked into keys at load
+	};
+
+	// axes of root translation moved out of the keys into root motion
+	enum a3_ClipRootMotionAxis
+	{
+		a3clipRoot_x = 0x1,
+		a3clipRoot_y = 0x2,
+		a3clipRoot_z = 0x4,
+		a3clipRoot_xy = 0x3,	// ground plane (z is up): keeps vertical bob in keys
+		a3clipRoot_xyz = 0x7,
+	};
+
 	// description of single clip
 	struct a3_Clip
 	{
@@ -61,6 +84,13 @@ extern "C"
 
 		// duration of frame (ditto)
 		float frameDuration, frameDurationInv;
+
+		// additive (default) or absolute key poses
+		a3_ClipPoseMode poseMode;
+
+		// root displacement from first key at each key, plus one entry 
+		//	for a whole cycle (count + 1 entries; null if not extracted)
+		p3vec4 *rootMotion;
 	};
 
 	// group of clips
@@ -82,6 +112,9 @@ extern "C"
 		float frameParam;
 		float clipTime;
 		float clipParam;
+
+		// root displacement over the last update (zero if clip has none)
+		p3vec4 rootDelta;
 	};
 
 
@@ -99,11 +132,33 @@ extern "C"
 	// initialize clip in group
 	inline int a3clipInit(const a3_ClipGroup *clipGroup, const unsigned int clipIndex, const char name[32], unsigned int firstFrameIndex, unsigned int lastFrameIndex, float duration);
 
+	// make clip absolute by concatenating the base pose into each of its 
+	//	key poses once, so evaluation needs no per-frame base pass
+	// fails if clip is already absolute, if the base pose is one of the 
+	//	clip's keys or if the keys are shared with any other clip
+	inline int a3clipBakeBasePose(const a3_ClipGroup *clipGroup, const unsigned int clipIndex, const a3_HierarchyPoseGroup *poseGroup, const unsigned int basePoseIndex, const a3_HierarchyPoseFlag flag);
+
+	// move root translation out of clip's keys into a displacement track 
+	//	so that looping does not snap the root back; the segment from the 
+	//	last key back to the first is assumed to move at the clip's average 
+	//	speed; the keys are modified, so each key may only be extracted once
+	// fails if clip already has root motion or shares keys with one that has
+	inline int a3clipExtractRootMotion(const a3_ClipGroup *clipGroup, const unsigned int clipIndex, const a3_HierarchyPoseGroup *poseGroup, const unsigned int rootIndex, const a3_ClipRootMotionAxis axis);
+
+	// sample clip's root displacement at time (any time: whole cycles 
+	//	before or after the clip accumulate)
+	inline int a3clipSampleRootMotion(const a3_Clip *clip, p3vec4 *displacement_out, const float clipTime);
+
 	// set clip controller to clip
 	//	(may want additional parameters)
 	inline int a3clipCtrlSet(a3_ClipController *ctrl, const a3_ClipGroup *clipGroup, const unsigned int clipIndex);
 
-	// update clip controller
+	// move clip controller to normalized time in its clip (wrapped to 
+	//	[0, 1)), e.g. to match the phase of another controller
+	inline int a3clipCtrlSetParam(a3_ClipController *ctrl, const float clipParam);
+
+	// update clip controller; also stores the root displacement covered 
+	//	by the time that passed (including across loops) in rootDelta
 	inline int a3clipCtrlUpdate(a3_ClipController *ctrl, const float dt);
 
 
@@ -0,0 +1,383 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_ClipStream.c
+	Implementation of clip streaming.
+*/
+
+#include "a3_ClipStream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// pack layout: header, clip table, then keys of each clip in table order
+typedef struct a3_ClipStreamPackHeader
+{
+	char tag[8];
+	unsigned int nodeCount, clipCount, poseCount;
+	unsigned int nodePoseBytes;
+} a3_ClipStreamPackHeader;
+
+typedef struct a3_ClipStreamPackClip
+{
+	char name[32];
+	unsigned int first, count;
+	float duration;
+	unsigned int poseMode;
+} a3_ClipStreamPackClip;
+
+static const char a3clipStreamPackTag[8] = "A3CLIPS";
+
+
+// worker thread: read one clip's keys into its slot
+long a3clipStreamLoad_internal(void *args)
+{
+	a3_ClipStreamWorker *worker = (a3_ClipStreamWorker *)args;
+	FILE *fp = fopen(worker->filePath, "rb");
+	worker->result = 0;
+	if (fp)
+	{
+		if (fseek(fp, worker->offset, SEEK_SET) == 0)
+			worker->result = fread(worker->nodePose_out, 1, worker->bytes, fp) == worker->bytes;
+		fclose(fp);
+	}
+	return worker->result;
+}
+
+// bring finished load back to the owning thread
+inline void a3clipStreamFinishLoad_internal(a3_ClipStream *stream, a3_ClipStreamWorker *worker)
+{
+	a3threadWait(worker->thread);
+	if (worker->result)
+	{
+		stream->clipState[worker->clipIndex] = a3clipStream_resident;
+		stream->slot[worker->slotIndex].lastUse = stream->time;
+		++stream->residentCount;
+		++stream->loadCount;
+	}
+	else
+	{
+		// unreadable: give the slot back; clip may be requested again
+		stream->clipState[worker->clipIndex] = a3clipStream_unloaded;
+		stream->clipSlot[worker->clipIndex] = -1;
+		stream->slot[worker->slotIndex].clipIndex = -1;
+		++stream->failCount;
+	}
+	worker->clipIndex = -1;
+}
+
+// find slot for a load: free, else least recently used resident clip 
+//	that was not used since the last update
+inline int a3clipStreamFindSlot_internal(a3_ClipStream *stream)
+{
+	const a3_ClipStreamSlot *slot;
+	unsigned int i, lastUse = stream->time;
+	int slotIndex = -1;
+	for (i = 0, slot = stream->slot; i < stream->slotCount; ++i, ++slot)
+	{
+		if (slot->clipIndex < 0)
+			return i;
+		if (stream->clipState[slot->clipIndex] == a3clipStream_resident && slot->lastUse < lastUse)
+		{
+			lastUse = slot->lastUse;
+			slotIndex = i;
+		}
+	}
+
+	// evict
+	if (slotIndex >= 0)
+	{
+		const int clipIndex = stream->slot[slotIndex].clipIndex;
+		stream->clipState[clipIndex] = a3clipStream_unloaded;
+		stream->clipSlot[clipIndex] = -1;
+		stream->slot[slotIndex].clipIndex = -1;
+		--stream->residentCount;
+		++stream->evictCount;
+	}
+	return slotIndex;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// save pack
+extern inline int a3clipStreamPackSave(const char *filePath, const a3_HierarchyPoseGroup *poseGroup, const a3_ClipGroup *clipGroup)
+{
+	if (filePath && *filePath && poseGroup && poseGroup->hierarchy && poseGroup->pose && clipGroup && clipGroup->clips)
+	{
+		a3_ClipStreamPackHeader header[1] = { 0 };
+		a3_ClipStreamPackClip record[1];
+		const a3_Clip *clip;
+		const unsigned int nodeCount = poseGroup->hierarchy->numNodes;
+		unsigned int i, first;
+		int bytes = 0;
+		FILE *fp;
+
+		// keys must exist
+		for (i = 0, clip = clipGroup->clips; i < clipGroup->clipCount; ++i, ++clip)
+			if (clip->last >= poseGroup->poseCount)
+				return -1;
+
+		fp = fopen(filePath, "wb");
+		if (!fp)
+			return -1;
+
+		memcpy(header->tag, a3clipStreamPackTag, sizeof(header->tag));
+		header->nodeCount = nodeCount;
+		header->clipCount = clipGroup->clipCount;
+		header->nodePoseBytes = sizeof(a3_HierarchyNodePose);
+		for (i = 0, clip = clipGroup->clips; i < clipGroup->clipCount; ++i, ++clip)
+			header->poseCount += clip->count;
+		bytes += (int)fwrite(header, 1, sizeof(header), fp);
+
+		// table: keys are renumbered by position in the pack
+		for (i = first = 0, clip = clipGroup->clips; i < clipGroup->clipCount; ++i, ++clip)
+		{
+			memset(record, 0, sizeof(record));
+			strncpy(record->name, clip->name, sizeof(record->name));
+			record->first = first;
+			record->count = clip->count;
+			record->duration = clip->clipDuration;
+			record->poseMode = clip->poseMode;
+			bytes += (int)fwrite(record, 1, sizeof(record), fp);
+			first += clip->count;
+		}
+
+		// keys (contiguous in the pose group)
+		for (i = 0, clip = clipGroup->clips; i < clipGroup->clipCount; ++i, ++clip)
+			bytes += (int)fwrite(poseGroup->pose[clip->first].nodePose, 1, clip->count * nodeCount * sizeof(a3_HierarchyNodePose), fp);
+
+		fclose(fp);
+		return bytes;
+	}
+	return -1;
+}
+
+// create stream
+extern inline int a3clipStreamCreate(a3_ClipStream *stream_out, const char *filePath, const a3_Hierarchy *hierarchy, const a3_HierarchyPose *placeholder_opt, const unsigned int memoryBudget, const unsigned int workerCount)
+{
+	if (stream_out && !stream_out->clipState && filePath && *filePath && strlen(filePath) < sizeof(stream_out->filePath) && 
+		hierarchy && hierarchy->nodes && workerCount)
+	{
+		a3_ClipStreamPackHeader header[1];
+		a3_ClipStreamPackClip record[1];
+		const unsigned int nodeCount = hierarchy->numNodes;
+		unsigned int i, slotBytes, slotCount, slotPoseMax = 0;
+		FILE *fp = fopen(filePath, "rb");
+		if (!fp)
+			return -1;
+
+		// header must match this hierarchy and build
+		if (fread(header, 1, sizeof(header), fp) != sizeof(header) || memcmp(header->tag, a3clipStreamPackTag, sizeof(header->tag)) || 
+			header->nodeCount != nodeCount || header->nodePoseBytes != sizeof(a3_HierarchyNodePose) || !header->clipCount || 
+			a3clipCreateGroup(stream_out->clipGroup, header->clipCount) < 0)
+		{
+			fclose(fp);
+			return -1;
+		}
+
+		// clip table
+		for (i = 0; i < header->clipCount; ++i)
+		{
+			if (fread(record, 1, sizeof(record), fp) != sizeof(record) || !record->count || record->first + record->count > header->poseCount)
+			{
+				fclose(fp);
+				a3clipReleaseGroup(stream_out->clipGroup);
+				return -1;
+			}
+			record->name[sizeof(record->name) - 1] = 0;
+			a3clipInit(stream_out->clipGroup, i, record->name, record->first, record->first + record->count - 1, record->duration);
+			stream_out->clipGroup->clips[i].poseMode = (a3_ClipPoseMode)record->poseMode;
+			if (slotPoseMax < record->count)
+				slotPoseMax = record->count;
+		}
+		fclose(fp);
+
+		// as many slots of the longest clip as fit; more than one per clip 
+		//	is never needed
+		slotBytes = slotPoseMax * nodeCount * sizeof(a3_HierarchyNodePose);
+		slotCount = memoryBudget / slotBytes;
+		if (slotCount > header->clipCount)
+			slotCount = header->clipCount;
+		if (!slotCount)
+		{
+			a3clipReleaseGroup(stream_out->clipGroup);
+			return -1;
+		}
+
+		strcpy(stream_out->filePath, filePath);
+		stream_out->dataOffset = (long)(sizeof(header) + header->clipCount * sizeof(record));
+		stream_out->slotCount = slotCount;
+		stream_out->slotPoseMax = slotPoseMax;
+		a3hierarchyPoseGroupCreate(stream_out->slotPoses, hierarchy, slotCount * slotPoseMax);
+		a3hierarchyPoseGroupCreate(stream_out->placeholder, hierarchy, 1);
+		if (placeholder_opt)
+			a3hierarchyPoseCopy(stream_out->placeholder->pose, placeholder_opt, nodeCount);
+
+		// per-clip state, slots
+		stream_out->clipState = (a3_ClipStreamState *)malloc(header->clipCount * (sizeof(a3_ClipStreamState) + sizeof(int)) + slotCount * sizeof(a3_ClipStreamSlot));
+		stream_out->clipSlot = (int *)(stream_out->clipState + header->clipCount);
+		stream_out->slot = (a3_ClipStreamSlot *)(stream_out->clipSlot + header->clipCount);
+		for (i = 0; i < header->clipCount; ++i)
+		{
+			stream_out->clipState[i] = a3clipStream_unloaded;
+			stream_out->clipSlot[i] = -1;
+		}
+		for (i = 0; i < slotCount; ++i)
+		{
+			stream_out->slot[i].clipIndex = -1;
+			stream_out->slot[i].lastUse = 0;
+		}
+
+		memset(stream_out->worker, 0, sizeof(stream_out->worker));
+		for (i = 0; i < a3clipStream_workerMax; ++i)
+			stream_out->worker[i].clipIndex = -1;
+		stream_out->workerCount = workerCount < a3clipStream_workerMax ? workerCount : a3clipStream_workerMax;
+		stream_out->requestCount = 0;
+		stream_out->time = 1;
+		stream_out->residentCount = stream_out->loadCount = stream_out->evictCount = stream_out->failCount = 0;
+		return slotCount;
+	}
+	return -1;
+}
+
+// release stream
+extern inline int a3clipStreamRelease(a3_ClipStream *stream)
+{
+	if (stream && stream->clipState)
+	{
+		unsigned int i;
+		for (i = 0; i < stream->workerCount; ++i)
+			if (stream->worker[i].clipIndex >= 0)
+				a3threadWait(stream->worker[i].thread);
+		free(stream->clipState);
+		a3hierarchyPoseGroupRelease(stream->slotPoses);
+		a3hierarchyPoseGroupRelease(stream->placeholder);
+		a3clipReleaseGroup(stream->clipGroup);
+		memset(stream, 0, sizeof(a3_ClipStream));
+		return 1;
+	}
+	return -1;
+}
+
+// update stream
+extern inline int a3clipStreamUpdate(a3_ClipStream *stream)
+{
+	if (stream && stream->clipState)
+	{
+		a3_ClipStreamWorker *worker;
+		const a3_Clip *clip;
+		unsigned int i;
+		int clipIndex, slotIndex;
+
+		// collect finished loads
+		for (i = 0, worker = stream->worker; i < stream->workerCount; ++i, ++worker)
+			if (worker->clipIndex >= 0 && a3threadIsRunning(worker->thread) <= 0)
+				a3clipStreamFinishLoad_internal(stream, worker);
+
+		// start queued loads in request order
+		for (i = 0, worker = stream->worker; i < stream->workerCount && stream->requestCount; ++i, ++worker)
+		{
+			if (worker->clipIndex >= 0)
+				continue;
+			slotIndex = a3clipStreamFindSlot_internal(stream);
+			if (slotIndex < 0)
+				break;
+
+			clipIndex = stream->request[0];
+			memmove(stream->request, stream->request + 1, --stream->requestCount * sizeof(int));
+			clip = stream->clipGroup->clips + clipIndex;
+
+			stream->slot[slotIndex].clipIndex = clipIndex;
+			stream->clipSlot[clipIndex] = slotIndex;
+			stream->clipState[clipIndex] = a3clipStream_loading;
+
+			worker->filePath = stream->filePath;
+			worker->nodePose_out = stream->slotPoses->pose[slotIndex * stream->slotPoseMax].nodePose;
+			worker->bytes = clip->count * stream->slotPoses->hierarchy->numNodes * sizeof(a3_HierarchyNodePose);
+			worker->offset = stream->dataOffset + (long)(clip->first * stream->slotPoses->hierarchy->numNodes * sizeof(a3_HierarchyNodePose));
+			worker->clipIndex = clipIndex;
+			worker->slotIndex = slotIndex;
+			worker->result = 0;
+
+			// launch wants an unused descriptor; the last load's is spent
+			memset(worker->thread, 0, sizeof(a3_Thread));
+			if (a3threadLaunch(worker->thread, a3clipStreamLoad_internal, worker, 0) <= 0)
+				a3clipStreamFinishLoad_internal(stream, worker);
+		}
+
+		++stream->time;
+		return stream->residentCount;
+	}
+	return -1;
+}
+
+// request clip
+extern inline int a3clipStreamRequest(a3_ClipStream *stream, const unsigned int clipIndex)
+{
+	if (stream && stream->clipState && clipIndex < stream->clipGroup->clipCount)
+	{
+		switch (stream->clipState[clipIndex])
+		{
+		case a3clipStream_resident:
+			stream->slot[stream->clipSlot[clipIndex]].lastUse = stream->time;
+			break;
+		case a3clipStream_unloaded:
+			// if the queue is full the clip is asked for again next time
+			if (stream->requestCount < a3clipStream_requestMax)
+			{
+				stream->request[stream->requestCount++] = clipIndex;
+				stream->clipState[clipIndex] = a3clipStream_queued;
+			}
+			break;
+		default:
+			break;
+		}
+		return stream->clipState[clipIndex];
+	}
+	return -1;
+}
+
+// get controller's poses
+extern inline int a3clipStreamGetPoses(a3_ClipStream *stream, const a3_ClipController *ctrl, const a3_HierarchyPose **pose0_out, const a3_HierarchyPose **pose1_out)
+{
+	if (stream && stream->clipState && ctrl && ctrl->clipGroup == stream->clipGroup && pose0_out && pose1_out)
+	{
+		if (a3clipStreamRequest(stream, ctrl->clipIndex) == a3clipStream_resident)
+		{
+			const a3_Clip *clip = stream->clipGroup->clips + ctrl->clipIndex;
+			const a3_HierarchyPose *slotPose = stream->slotPoses->pose + stream->clipSlot[ctrl->clipIndex] * stream->slotPoseMax;
+			*pose0_out = slotPose + (ctrl->frameIndex - clip->first);
+			*pose1_out = slotPose + (ctrl->nextIndex - clip->first);
+			return 1;
+		}
+		*pose0_out = *pose1_out = stream->placeholder->pose;
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,168 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_ClipStream.h
+	Clip streaming: clips are packed into a file and loaded on demand by 
+		worker threads into a fixed number of equal slots that fit a memory 
+		budget; the least recently used clip is evicted to make room. Until 
+		a clip is resident, its controllers get a placeholder pose.
+*/
+
+#ifndef __ANIMAL3D_CLIPSTREAM_H
+#define __ANIMAL3D_CLIPSTREAM_H
+
+
+#include "a3_HierarchyState.h"
+#include "a3_ClipControl.h"
+
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_ClipStreamSlot		a3_ClipStreamSlot;
+	typedef struct a3_ClipStreamWorker		a3_ClipStreamWorker;
+	typedef struct a3_ClipStream			a3_ClipStream;
+	typedef enum a3_ClipStreamMaxCounts		a3_ClipStreamMaxCounts;
+	typedef enum a3_ClipStreamState			a3_ClipStreamState;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fixed limits
+	enum a3_ClipStreamMaxCounts
+	{
+		a3clipStream_workerMax = 4,		// loads in flight
+		a3clipStream_requestMax = 64,	// loads waiting for a worker
+	};
+
+	// residency of a clip
+	enum a3_ClipStreamState
+	{
+		a3clipStream_unloaded,
+		a3clipStream_queued,
+		a3clipStream_loading,
+		a3clipStream_resident,
+	};
+
+	// room for the keys of one clip
+	struct a3_ClipStreamSlot
+	{
+		// clip held (negative if free) and update it was last used in
+		int clipIndex;
+		unsigned int lastUse;
+	};
+
+	// load in flight; only its thread touches the slot until it is joined
+	struct a3_ClipStreamWorker
+	{
+		a3_Thread thread[1];
+		const char *filePath;
+		a3_HierarchyNodePose *nodePose_out;
+		long offset;
+		unsigned int bytes;
+		int clipIndex, slotIndex;
+		int result;
+	};
+
+	// streaming service; only the owning thread calls the functions below
+	struct a3_ClipStream
+	{
+		char filePath[256];
+
+		// clips from the pack; key indices are positions in the pack, so 
+		//	controllers work in clip terms and are resolved through the stream
+		a3_ClipGroup clipGroup[1];
+		a3_ClipStreamState *clipState;
+		int *clipSlot;
+		long dataOffset;
+
+		// slot storage: slotPoseMax poses per slot, enough for longest clip
+		a3_HierarchyPoseGroup slotPoses[1];
+		a3_ClipStreamSlot *slot;
+		unsigned int slotCount, slotPoseMax;
+
+		// returned for clips that are not resident
+		a3_HierarchyPoseGroup placeholder[1];
+
+		a3_ClipStreamWorker worker[a3clipStream_workerMax];
+		unsigned int workerCount;
+
+		int request[a3clipStream_requestMax];
+		unsigned int requestCount;
+
+		// update counter for recency, and counters for tuning the budget
+		unsigned int time;
+		unsigned int residentCount, loadCount, evictCount, failCount;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// write all clips in group and their keys to a pack file (native 
+	//	layout, read back on the same platform); keys shared by clips are 
+	//	written for each of them
+	// returns number of bytes written
+	inline int a3clipStreamPackSave(const char *filePath, const a3_HierarchyPoseGroup *poseGroup, const a3_ClipGroup *clipGroup);
+
+	// open pack for streaming: reads the clip table only; slots are sized 
+	//	for the longest clip and as many as fit in memoryBudget bytes of 
+	//	keys are made; placeholder_opt is copied (reset pose if null) and 
+	//	should suit the clips' pose mode, e.g. the base pose for absolute 
+	//	clips
+	// returns slot count, or -1 if pack does not match hierarchy or budget 
+	//	cannot hold the longest clip
+	inline int a3clipStreamCreate(a3_ClipStream *stream_out, const char *filePath, const a3_Hierarchy *hierarchy, const a3_HierarchyPose *placeholder_opt, const unsigned int memoryBudget, const unsigned int workerCount);
+
+	// wait for loads in flight and release everything
+	inline int a3clipStreamRelease(a3_ClipStream *stream);
+
+	// call once per frame: collect finished loads, start queued loads on 
+	//	idle workers (evicting the least recently used clip that was not 
+	//	used since the last update if there is no free slot)
+	// returns resident clip count
+	inline int a3clipStreamUpdate(a3_ClipStream *stream);
+
+	// mark clip as used, queueing a load if it is not resident (e.g. ahead 
+	//	of a transition to it)
+	// returns clip state
+	inline int a3clipStreamRequest(a3_ClipStream *stream, const unsigned int clipIndex);
+
+	// resolve controller (set to the stream's clip group) to its two keys; 
+	//	both are the placeholder while the clip is not resident
+	// returns 1 if resident, 0 if placeholder
+	inline int a3clipStreamGetPoses(a3_ClipStream *stream, const a3_ClipController *ctrl, const a3_HierarchyPose **pose0_out, const a3_HierarchyPose **pose1_out);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_CLIPSTREAM_H
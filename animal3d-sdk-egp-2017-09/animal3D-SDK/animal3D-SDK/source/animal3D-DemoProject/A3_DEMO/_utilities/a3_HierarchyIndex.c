@@ -0,0 +1,190 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_HierarchyIndex.c
+	Implementation of hierarchy index.
+*/
+
+#include "a3_HierarchyIndex.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// range test in depth-first order
+inline int a3hierarchyIndexIsAncestor_internal(const a3_HierarchyIndex *index, const unsigned int ancestorIndex, const unsigned int otherIndex)
+{
+	const unsigned int position = index->position[otherIndex];
+	return (position >= index->position[ancestorIndex] && position < index->subtreeEnd[ancestorIndex]);
+}
+
+
+//-----------------------------------------------------------------------------
+
+// create index
+extern inline int a3hierarchyIndexCreate(a3_HierarchyIndex *index_out, const a3_Hierarchy *hierarchy, const int useAncestorBits)
+{
+	if (index_out && hierarchy && hierarchy->nodes && hierarchy->numNodes && !index_out->order)
+	{
+		const a3_HierarchyNode *nodes = hierarchy->nodes;
+		const unsigned int nodeCount = hierarchy->numNodes;
+		const unsigned int words = useAncestorBits ? (nodeCount + 31) / 32 : 0;
+		unsigned int i, cursor, rootCursor;
+		int parentIndex, child;
+
+		// single allocation for all tables
+		index_out->order = (unsigned int *)malloc((7 * nodeCount + words * nodeCount) * sizeof(unsigned int));
+		index_out->position = index_out->order + nodeCount;
+		index_out->subtreeEnd = index_out->position + nodeCount;
+		index_out->firstChild = (int *)(index_out->subtreeEnd + nodeCount);
+		index_out->nextSibling = index_out->firstChild + nodeCount;
+		index_out->childCount = (unsigned int *)(index_out->nextSibling + nodeCount);
+		index_out->depth = index_out->childCount + nodeCount;
+		index_out->ancestorBits = words ? index_out->depth + nodeCount : 0;
+		index_out->ancestorWords = words;
+		index_out->hierarchy = hierarchy;
+		index_out->nodeCount = nodeCount;
+
+		// child links: walk backwards so each list comes out in node order; 
+		//	subtree sizes accumulate into parents the same way (parents 
+		//	always come before children), using subtree end as storage
+		memset(index_out->childCount, 0, nodeCount * sizeof(unsigned int));
+		for (i = 0; i < nodeCount; ++i)
+		{
+			index_out->firstChild[i] = index_out->nextSibling[i] = -1;
+			index_out->subtreeEnd[i] = 1;
+		}
+		for (i = nodeCount; i-- > 0; )
+		{
+			parentIndex = nodes[i].parentIndex;
+			if (parentIndex >= 0)
+			{
+				index_out->nextSibling[i] = index_out->firstChild[parentIndex];
+				index_out->firstChild[parentIndex] = i;
+				++index_out->childCount[parentIndex];
+				index_out->subtreeEnd[parentIndex] += index_out->subtreeEnd[i];
+			}
+		}
+
+		// depth and depth-first positions, going forward: each node places 
+		//	its children one subtree after another right after itself
+		index_out->depthMax = 0;
+		for (i = 0, rootCursor = 0; i < nodeCount; ++i)
+		{
+			parentIndex = nodes[i].parentIndex;
+			if (parentIndex >= 0)
+				index_out->depth[i] = index_out->depth[parentIndex] + 1;
+			else
+			{
+				index_out->depth[i] = 0;
+				index_out->position[i] = rootCursor;
+				rootCursor += index_out->subtreeEnd[i];
+			}
+			index_out->depthMax = index_out->depth[i] > index_out->depthMax ? index_out->depth[i] : index_out->depthMax;
+
+			for (child = index_out->firstChild[i], cursor = index_out->position[i] + 1; child >= 0; child = index_out->nextSibling[child])
+			{
+				index_out->position[child] = cursor;
+				cursor += index_out->subtreeEnd[child];
+			}
+
+			// size becomes end of range
+			index_out->subtreeEnd[i] += index_out->position[i];
+			index_out->order[index_out->position[i]] = i;
+		}
+
+		// ancestor bits: copy parent's row and add self
+		if (words)
+		{
+			unsigned int *row = index_out->ancestorBits;
+			for (i = 0; i < nodeCount; ++i, row += words)
+			{
+				parentIndex = nodes[i].parentIndex;
+				if (parentIndex >= 0)
+					memcpy(row, index_out->ancestorBits + parentIndex * words, words * sizeof(unsigned int));
+				else
+					memset(row, 0, words * sizeof(unsigned int));
+				row[i / 32] |= 1u << (i % 32);
+			}
+		}
+
+		// done
+		return nodeCount;
+	}
+	return -1;
+}
+
+// release index
+extern inline int a3hierarchyIndexRelease(a3_HierarchyIndex *index)
+{
+	if (index && index->order)
+	{
+		free(index->order);
+		index->order = index->position = index->subtreeEnd = 0;
+		index->firstChild = index->nextSibling = 0;
+		index->childCount = index->depth = index->ancestorBits = 0;
+		index->hierarchy = 0;
+		index->nodeCount = index->ancestorWords = index->depthMax = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// ancestor test
+extern inline int a3hierarchyIndexIsAncestor(const a3_HierarchyIndex *index, const unsigned int ancestorIndex, const unsigned int otherIndex)
+{
+	if (index && index->order && ancestorIndex < index->nodeCount && otherIndex < index->nodeCount)
+		return a3hierarchyIndexIsAncestor_internal(index, ancestorIndex, otherIndex);
+	return -1;
+}
+
+// descendant test
+extern inline int a3hierarchyIndexIsDescendant(const a3_HierarchyIndex *index, const unsigned int descendantIndex, const unsigned int otherIndex)
+{
+	return a3hierarchyIndexIsAncestor(index, otherIndex, descendantIndex);
+}
+
+// subtree mask
+extern inline int a3hierarchyIndexSetSubtreeMask(unsigned char *mask_out, const a3_HierarchyIndex *index, const unsigned int nodeIndex, const unsigned char value)
+{
+	if (mask_out && index && index->order && nodeIndex < index->nodeCount)
+	{
+		const unsigned int *order = index->order + index->position[nodeIndex], *const end = index->order + index->subtreeEnd[nodeIndex];
+		const unsigned int count = (unsigned int)(end - order);
+		while (order < end)
+			mask_out[*(order++)] = value;
+		return count;
+	}
+	return -1;
+}
+
+// ancestor bitset row
+extern inline const unsigned int *a3hierarchyIndexGetAncestorBits(const a3_HierarchyIndex *index, const unsigned int nodeIndex)
+{
+	if (index && index->ancestorBits && nodeIndex < index->nodeCount)
+		return (index->ancestorBits + nodeIndex * index->ancestorWords);
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
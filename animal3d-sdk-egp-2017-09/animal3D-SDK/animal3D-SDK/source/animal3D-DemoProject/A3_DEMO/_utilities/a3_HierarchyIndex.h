@@ -0,0 +1,110 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_HierarchyIndex.h
+	Derived lookup tables for a finished hierarchy: depth-first order with 
+		subtree ranges, child and sibling links, depths and optional 
+		ancestor bitsets, so relationship tests are constant time and 
+		subtree operations are contiguous ranges.
+*/
+
+#ifndef __ANIMAL3D_HIERARCHYINDEX_H
+#define __ANIMAL3D_HIERARCHYINDEX_H
+
+
+// A3 hierarchy
+#include "animal3D/a3animation/a3_Hierarchy.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_HierarchyIndex	a3_HierarchyIndex;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// hierarchy index; build after all nodes have been set, and rebuild 
+	//	if the hierarchy changes
+	struct a3_HierarchyIndex
+	{
+		// source hierarchy and its node count
+		const a3_Hierarchy *hierarchy;
+		unsigned int nodeCount;
+
+		// depth-first order: order[k] is the node at position k, and 
+		//	position[i] is the position of node i; the subtree of node i 
+		//	(including itself) occupies positions [position[i], subtreeEnd[i])
+		unsigned int *order, *position, *subtreeEnd;
+
+		// first child and next sibling of each node, in node order 
+		//	(-1 if none), and number of children
+		int *firstChild, *nextSibling;
+		unsigned int *childCount;
+
+		// distance from root (roots are zero) and deepest value
+		unsigned int *depth, depthMax;
+
+		// optional ancestor bitsets: one row of words per node, with a bit 
+		//	set for the node itself and each of its ancestors (null if unused)
+		unsigned int *ancestorBits, ancestorWords;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create index from initialized hierarchy; ancestor bitsets take 
+	//	(nodes^2 / 8) bytes and are only built if requested
+	//	return: node count, or -1 if invalid params
+	inline int a3hierarchyIndexCreate(a3_HierarchyIndex *index_out, const a3_Hierarchy *hierarchy, const int useAncestorBits);
+
+	// release index
+	inline int a3hierarchyIndexRelease(a3_HierarchyIndex *index);
+
+	// constant-time version of a3hierarchyIsAncestorNode (a node counts as 
+	//	its own ancestor, as there)
+	//	return: 1 if true, 0 if false, -1 if invalid params
+	inline int a3hierarchyIndexIsAncestor(const a3_HierarchyIndex *index, const unsigned int ancestorIndex, const unsigned int otherIndex);
+
+	// same test using descendant as the first node
+	inline int a3hierarchyIndexIsDescendant(const a3_HierarchyIndex *index, const unsigned int descendantIndex, const unsigned int otherIndex);
+
+	// set mask entries (one byte per node, node order) for a subtree
+	//	return: number of nodes in subtree, or -1 if invalid params
+	inline int a3hierarchyIndexSetSubtreeMask(unsigned char *mask_out, const a3_HierarchyIndex *index, const unsigned int nodeIndex, const unsigned char value);
+
+	// get ancestor bitset row for node (null if bitsets were not built)
+	inline const unsigned int *a3hierarchyIndexGetAncestorBits(const a3_HierarchyIndex *index, const unsigned int nodeIndex);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_HIERARCHYINDEX_H
@@ -55,6 +55,25 @@ inline void a3hierarchyPoseReset_internal(const a3_HierarchyPose *pose, const un
 }
 
 
+// convert Euler to quaternion, aligned with reference if provided
+inline void a3hierarchyNodePoseConvertEulerToQuat_internal(a3_HierarchyNodePose *nodePose, const a3_HierarchyNodePose *alignNodePose)
+{
+	p3real *q = nodePose->orientation.v;
+	a3quatCreateEulerZYX(q, q[0], q[1], q[2]);
+	if (alignNodePose)
+	{
+		const p3real *r = alignNodePose->orientation.v;
+		if (q[0] * r[0] + q[1] * r[1] + q[2] * r[2] + q[3] * r[3] < realZero)
+		{
+			q[0] = -q[0];
+			q[1] = -q[1];
+			q[2] = -q[2];
+			q[3] = -q[3];
+		}
+	}
+}
+
+
 // copy pose
 inline void a3hierarchyNodePoseCopy_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *copyNodePose)
 {
@@ -120,6 +139,18 @@ inline void a3hierarchyNodePoseLERP_quaternion_internal(a3_HierarchyNodePose *no
 	p3real4Lerp(nodePose_out->scale.v, nodePose0->scale.v, nodePose1->scale.v, param);
 }
 
+inline void a3hierarchyNodePoseLERP_quaternion_fast_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose0, const a3_HierarchyNodePose *nodePose1, const float param)
+{
+	// rotation: approximate slerp
+	a3quatUnitSLERPFast(nodePose_out->orientation.v, nodePose0->orientation.v, nodePose1->orientation.v, param);
+
+	// translation: lerp
+	p3real4Lerp(nodePose_out->translation.v, nodePose0->translation.v, nodePose1->translation.v, param);
+
+	// scale: lerp
+	p3real4Lerp(nodePose_out->scale.v, nodePose0->scale.v, nodePose1->scale.v, param);
+}
+
 inline void a3hierarchyNodePoseConcat_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose0, const a3_HierarchyNodePose *nodePose1)
 {
 	// rotation: add
@@ -174,6 +205,18 @@ inline void a3hierarchyNodePoseScale_quaternion_internal(a3_HierarchyNodePose *n
 	p3real4Lerp(nodePose_out->scale.v, p3oneVec4.v, nodePose->scale.v, param);
 }
 
+inline void a3hierarchyNodePoseScale_quaternion_fast_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose* nodePose, const float param)
+{
+	// rotation: approximate slerp from identity
+	a3quatUnitSLERPFast(nodePose_out->orientation.v, p3wVec4.v, nodePose->orientation.v, param);
+
+	// translation: scalar multiply
+	p3real4ProductS(nodePose_out->translation.v, nodePose->translation.v, param);
+
+	// scale: lerp from 1
+	p3real4Lerp(nodePose_out->scale.v, p3oneVec4.v, nodePose->scale.v, param);
+}
+
 inline void a3hierarchyNodePoseBlend_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose* nodePose0, const a3_HierarchyNodePose* nodePose1, const float param0, const float param1)
 {
 	a3_HierarchyNodePose tmpPose0[1], tmpPose1[1];
@@ -202,9 +245,23 @@ inline void a3hierarchyNodePoseBlend_quaternion_internal(a3_HierarchyNodePose *n
 	a3hierarchyNodePoseConcat_quaternion_internal(nodePose_out, tmpPose0, tmpPose1);
 }
 
+inline void a3hierarchyNodePoseBlend_quaternion_fast_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose* nodePose0, const a3_HierarchyNodePose* nodePose1, const float param0, const float param1)
+{
+	a3_HierarchyNodePose tmpPose0[1], tmpPose1[1];
+
+	// scale pose0 by weight0
+	a3hierarchyNodePoseScale_quaternion_fast_internal(tmpPose0, nodePose0, param0);
+
+	// scale pose1 by weight1
+	a3hierarchyNodePoseScale_quaternion_fast_internal(tmpPose1, nodePose1, param1);
+
+	// add the results
+	a3hierarchyNodePoseConcat_quaternion_internal(nodePose_out, tmpPose0, tmpPose1);
+}
+
 inline void a3hierarchyNodePoseTriangularLERP_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose0, const a3_HierarchyNodePose *nodePose1, const a3_HierarchyNodePose *nodePose2, const float param0, const float param1, const float param2)
 {
-	a3_HierarchyNodePose* tmpBlend[1], tmpScale[1];
+	a3_HierarchyNodePose tmpBlend[1], tmpScale[1];
 
 	a3hierarchyNodePoseBlend_internal(tmpBlend, nodePose0, nodePose1, param0, param1);
 	a3hierarchyNodePoseScale_internal(tmpScale, nodePose2, param2);
@@ -213,13 +270,47 @@ inline void a3hierarchyNodePoseTriangularLERP_internal(a3_HierarchyNodePose *nod
 
 inline void a3hierarchyNodePoseTriangularLERP_quaternion_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose0, const a3_HierarchyNodePose *nodePose1, const a3_HierarchyNodePose *nodePose2, const float param0, const float param1, const float param2)
 {
-	a3_HierarchyNodePose* tmpBlend[1], tmpScale[1];
+	a3_HierarchyNodePose tmpBlend[1], tmpScale[1];
 
 	a3hierarchyNodePoseBlend_quaternion_internal(tmpBlend, nodePose0, nodePose1, param0, param1);
 	a3hierarchyNodePoseScale_quaternion_internal(tmpScale, nodePose2, param2);
 	a3hierarchyNodePoseConcat_quaternion_internal(nodePose_out, tmpBlend, tmpScale);
 }
 
+inline void a3hierarchyNodePoseTriangularLERP_quaternion_fast_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose0, const a3_HierarchyNodePose *nodePose1, const a3_HierarchyNodePose *nodePose2, const float param0, const float param1, const float param2)
+{
+	a3_HierarchyNodePose tmpBlend[1], tmpScale[1];
+
+	a3hierarchyNodePoseBlend_quaternion_fast_internal(tmpBlend, nodePose0, nodePose1, param0, param1);
+	a3hierarchyNodePoseScale_quaternion_fast_internal(tmpScale, nodePose2, param2);
+	a3hierarchyNodePoseConcat_quaternion_internal(nodePose_out, tmpBlend, tmpScale);
+}
+
+inline void a3hierarchyNodePoseAddLayer_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose, const a3_HierarchyNodePose *layerNodePose, const float weight)
+{
+	a3_HierarchyNodePose tmpScale[1];
+
+	// scale layer by weight, then add on top
+	a3hierarchyNodePoseScale_internal(tmpScale, layerNodePose, weight);
+	a3hierarchyNodePoseConcat_internal(nodePose_out, nodePose, tmpScale);
+}
+
+inline void a3hierarchyNodePoseAddLayer_quaternion_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose, const a3_HierarchyNodePose *layerNodePose, const float weight)
+{
+	a3_HierarchyNodePose tmpScale[1];
+
+	a3hierarchyNodePoseScale_quaternion_internal(tmpScale, layerNodePose, weight);
+	a3hierarchyNodePoseConcat_quaternion_internal(nodePose_out, nodePose, tmpScale);
+}
+
+inline void a3hierarchyNodePoseAddLayer_quaternion_fast_internal(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose, const a3_HierarchyNodePose *layerNodePose, const float weight)
+{
+	a3_HierarchyNodePose tmpScale[1];
+
+	a3hierarchyNodePoseScale_quaternion_fast_internal(tmpScale, layerNodePose, weight);
+	a3hierarchyNodePoseConcat_quaternion_internal(nodePose_out, nodePose, tmpScale);
+}
+
 inline void a3hierarchyPoseLERP_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const float param, const unsigned int nodeCount)
 {
 	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
@@ -238,6 +329,15 @@ inline void a3hierarchyPoseLERP_quaternion_internal(a3_HierarchyPose *pose_out,
 		a3hierarchyNodePoseLERP_quaternion_internal(nodePose_out++, nodePose0++, nodePose1++, param);
 }
 
+inline void a3hierarchyPoseLERP_quaternion_fast_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const float param, const unsigned int nodeCount)
+{
+	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
+	const a3_HierarchyNodePose *nodePose0 = pose0->nodePose, *nodePose1 = pose1->nodePose;
+
+	while (nodePose_out < end)
+		a3hierarchyNodePoseLERP_quaternion_fast_internal(nodePose_out++, nodePose0++, nodePose1++, param);
+}
+
 inline void a3hierarchyPoseConcat_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const unsigned int nodeCount)
 {
 	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
@@ -274,6 +374,15 @@ inline void a3hierarchyPoseScale_quaternion_internal(a3_HierarchyPose *pose_out,
 		a3hierarchyNodePoseScale_quaternion_internal(nodePose_out++, nodePose++, param);
 }
 
+inline void a3hierarchyPoseScale_quaternion_fast_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const float param, const unsigned int nodeCount)
+{
+	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
+	const a3_HierarchyNodePose *nodePose = pose0->nodePose;
+
+	while (nodePose_out < end)
+		a3hierarchyNodePoseScale_quaternion_fast_internal(nodePose_out++, nodePose++, param);
+}
+
 inline void a3hierarchyPoseBlend_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const float param0, const float param1, const unsigned int nodeCount)
 {
 	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
@@ -292,6 +401,15 @@ inline void a3hierarchyPoseBlend_quaternion_internal(a3_HierarchyPose *pose_out,
 		a3hierarchyNodePoseBlend_quaternion_internal(nodePose_out++, nodePose0++, nodePose1++, param0, param1);
 }
 
+inline void a3hierarchyPoseBlend_quaternion_fast_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const float param0, const float param1, const unsigned int nodeCount)
+{
+	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
+	const a3_HierarchyNodePose *nodePose0 = pose0->nodePose, *nodePose1 = pose1->nodePose;
+
+	while (nodePose_out < end)
+		a3hierarchyNodePoseBlend_quaternion_fast_internal(nodePose_out++, nodePose0++, nodePose1++, param0, param1);
+}
+
 inline void a3hierarchyPoseTriangularLERP_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const a3_HierarchyPose *pose2, const float param0, const float param1, const float param2, const unsigned int nodeCount)
 {
 	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
@@ -310,6 +428,15 @@ inline void a3hierarchyPoseTriangularLERP_quaternion_internal(a3_HierarchyPose *
 		a3hierarchyNodePoseTriangularLERP_quaternion_internal(nodePose_out++, nodePose0++, nodePose1++, nodePose2++, param0, param1, param2);
 }
 
+inline void a3hierarchyPoseTriangularLERP_quaternion_fast_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const a3_HierarchyPose *pose2, const float param0, const float param1, const float param2, const unsigned int nodeCount)
+{
+	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
+	const a3_HierarchyNodePose *nodePose0 = pose0->nodePose, *nodePose1 = pose1->nodePose, *nodePose2 = pose2->nodePose;
+
+	while (nodePose_out < end)
+		a3hierarchyNodePoseTriangularLERP_quaternion_fast_internal(nodePose_out++, nodePose0++, nodePose1++, nodePose2++, param0, param1, param2);
+}
+
 // convert pose to transformation matrix
 // different versions for efficiency when calling per-set functions
 //	(significantly reduces the number of comparisons)
@@ -430,6 +557,33 @@ inline void a3hierarchyNodePoseConvert_translate_internal(p3mat4 *mat_out, const
 
 
 // same as the above with loops
+inline void a3hierarchyPoseAddLayer_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose, const a3_HierarchyPose *layerPose, const float weight, const unsigned int nodeCount)
+{
+	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
+	const a3_HierarchyNodePose *nodePose = pose->nodePose, *layerNodePose = layerPose->nodePose;
+
+	while (nodePose_out < end)
+		a3hierarchyNodePoseAddLayer_internal(nodePose_out++, nodePose++, layerNodePose++, weight);
+}
+
+inline void a3hierarchyPoseAddLayer_quaternion_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose, const a3_HierarchyPose *layerPose, const float weight, const unsigned int nodeCount)
+{
+	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
+	const a3_HierarchyNodePose *nodePose = pose->nodePose, *layerNodePose = layerPose->nodePose;
+
+	while (nodePose_out < end)
+		a3hierarchyNodePoseAddLayer_quaternion_internal(nodePose_out++, nodePose++, layerNodePose++, weight);
+}
+
+inline void a3hierarchyPoseAddLayer_quaternion_fast_internal(a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose, const a3_HierarchyPose *layerPose, const float weight, const unsigned int nodeCount)
+{
+	a3_HierarchyNodePose *nodePose_out = pose_out->nodePose, *const end = nodePose_out + nodeCount;
+	const a3_HierarchyNodePose *nodePose = pose->nodePose, *layerNodePose = layerPose->nodePose;
+
+	while (nodePose_out < end)
+		a3hierarchyNodePoseAddLayer_quaternion_fast_internal(nodePose_out++, nodePose++, layerNodePose++, weight);
+}
+
 inline void a3hierarchyPoseConvert_identity_internal(const a3_HierarchyTransform *transform_out, const a3_HierarchyPose *pose, const unsigned int nodeCount)
 {
 	p3mat4 *mat_out = transform_out->transform;
@@ -527,6 +681,30 @@ inline void a3hierarchyPoseConvert_translate_internal(const a3_HierarchyTransfor
 }
 
 
+// copy transforms
+inline void a3hierarchyTransformCopy_internal(const a3_HierarchyTransform *transform_out, const a3_HierarchyTransform *copyTransform, const unsigned int nodeCount)
+{
+	p3mat4 *mat_out = transform_out->transform, *const end = mat_out + nodeCount;
+	const p3mat4 *copyMat = copyTransform->transform;
+	while (mat_out < end)
+		*(mat_out++) = *(copyMat++);
+}
+
+// LERP transforms: each column is interpolated independently
+inline void a3hierarchyTransformLERP_internal(const a3_HierarchyTransform *transform_out, const a3_HierarchyTransform *transform0, const a3_HierarchyTransform *transform1, const float param, const unsigned int nodeCount)
+{
+	p3mat4 *mat_out = transform_out->transform, *const end = mat_out + nodeCount;
+	const p3mat4 *mat0 = transform0->transform, *mat1 = transform1->transform;
+	for (; mat_out < end; ++mat_out, ++mat0, ++mat1)
+	{
+		p3real4Lerp(mat_out->v0.v, mat0->v0.v, mat1->v0.v, param);
+		p3real4Lerp(mat_out->v1.v, mat0->v1.v, mat1->v1.v, param);
+		p3real4Lerp(mat_out->v2.v, mat0->v2.v, mat1->v2.v, param);
+		p3real4Lerp(mat_out->v3.v, mat0->v3.v, mat1->v3.v, param);
+	}
+}
+
+
 //-----------------------------------------------------------------------------
 
 // initialize pose set given an initialized hierarchy and key pose count
@@ -599,6 +777,25 @@ extern inline int a3hierarchyPoseGroupGetNodePoseOffsetIndex(const a3_HierarchyP
 	return -1;
 }
 
+// convert Euler orientations in pose group to quaternions
+extern inline int a3hierarchyPoseGroupConvertEulerToQuat(const a3_HierarchyPoseGroup *poseGroup)
+{
+	if (poseGroup && poseGroup->hierarchy)
+	{
+		// first pose has nothing to align with, all others use the one before
+		const unsigned int nodeCount = poseGroup->hierarchy->numNodes;
+		a3_HierarchyNodePose *nodePose = poseGroup->nodePoseContiguous, *const end = nodePose + nodeCount * poseGroup->poseCount;
+		const a3_HierarchyNodePose *const start = nodePose + nodeCount;
+		while (nodePose < end)
+		{
+			a3hierarchyNodePoseConvertEulerToQuat_internal(nodePose, nodePose >= start ? nodePose - nodeCount : 0);
+			++nodePose;
+		}
+		return poseGroup->poseCount;
+	}
+	return -1;
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -660,6 +857,67 @@ extern inline int a3hierarchyStateRelease(a3_HierarchyState *state)
 }
 
 
+//-----------------------------------------------------------------------------
+
+// create pose pool
+extern inline int a3hierarchyPosePoolCreate(a3_HierarchyPosePool *pool_out, const a3_Hierarchy *hierarchy, const unsigned int poseCount)
+{
+	if (pool_out && !pool_out->freeIndex && poseCount)
+	{
+		unsigned int i;
+		if (a3hierarchyPoseGroupCreate(pool_out->poseGroup, hierarchy, poseCount) < 0)
+			return -1;
+
+		// all poses start out free
+		pool_out->freeIndex = (unsigned int *)malloc(poseCount * sizeof(unsigned int));
+		for (i = 0; i < poseCount; ++i)
+			pool_out->freeIndex[i] = poseCount - 1 - i;
+		pool_out->freeCount = poseCount;
+		return poseCount;
+	}
+	return -1;
+}
+
+// release pose pool
+extern inline int a3hierarchyPosePoolRelease(a3_HierarchyPosePool *pool)
+{
+	if (pool && pool->freeIndex)
+	{
+		a3hierarchyPoseGroupRelease(pool->poseGroup);
+		free(pool->freeIndex);
+		pool->freeIndex = 0;
+		pool->freeCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// acquire pose from pool
+extern inline int a3hierarchyPosePoolAcquire(a3_HierarchyPosePool *pool, const a3_HierarchyPose **pose_out)
+{
+	if (pool && pool->freeIndex && pose_out && pool->freeCount)
+	{
+		const unsigned int index = pool->freeIndex[--pool->freeCount];
+		*pose_out = pool->poseGroup->pose + index;
+		return index;
+	}
+	return -1;
+}
+
+// return pose to pool
+extern inline int a3hierarchyPosePoolReturn(a3_HierarchyPosePool *pool, const a3_HierarchyPose *pose)
+{
+	if (pool && pool->freeIndex && pose && 
+		pose >= pool->poseGroup->pose && pose < pool->poseGroup->pose + pool->poseGroup->poseCount && 
+		pool->freeCount < pool->poseGroup->poseCount)
+	{
+		pool->freeIndex[pool->freeCount++] = (unsigned int)(pose - pool->poseGroup->pose);
+		return 1;
+	}
+	return -1;
+}
+
+
 //-----------------------------------------------------------------------------
 // ****TO-DO: implement single-node blend operations
 // ****TO-DO: implement full-pose blend operations
@@ -702,7 +960,9 @@ extern inline int a3hierarchyNodePoseLERP(a3_HierarchyNodePose *nodePose_out, co
 {
 	if (nodePose_out && nodePose0 && nodePose1)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyNodePoseLERP_quaternion_fast_internal(nodePose_out, nodePose0, nodePose1, param);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyNodePoseLERP_quaternion_internal(nodePose_out, nodePose0, nodePose1, param);
 		else
 			a3hierarchyNodePoseLERP_internal(nodePose_out, nodePose0, nodePose1, param);
@@ -730,7 +990,9 @@ extern inline int a3hierarchyNodePoseScale(a3_HierarchyNodePose *nodePose_out, c
 {
 	if (nodePose_out && nodePoseScale)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyNodePoseScale_quaternion_fast_internal(nodePose_out, nodePoseScale, param);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyNodePoseScale_quaternion_internal(nodePose_out, nodePoseScale, param);
 		else
 			a3hierarchyNodePoseScale_internal(nodePose_out, nodePoseScale, param);
@@ -744,7 +1006,9 @@ extern inline int a3hierarchyNodePoseBlend(a3_HierarchyNodePose *nodePose_out, c
 {
 	if (nodePose_out && nodePose0 && nodePose1)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyNodePoseBlend_quaternion_fast_internal(nodePose_out, nodePose0, nodePose1, weight0, weight1);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyNodePoseBlend_quaternion_internal(nodePose_out, nodePose0, nodePose1, weight0, weight1);
 		else
 			a3hierarchyNodePoseBlend_internal(nodePose_out, nodePose0, nodePose1, weight0, weight1);
@@ -758,7 +1022,9 @@ extern inline int a3hierarchyNodePoseTriangularLERP(a3_HierarchyNodePose *nodePo
 {
 	if (nodePose_out && nodePose0 && nodePose1 && nodePose2)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyNodePoseTriangularLERP_quaternion_fast_internal(nodePose_out, nodePose0, nodePose1, nodePose2, param0, param1, 1 - param0 - param1);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyNodePoseTriangularLERP_quaternion_internal(nodePose_out, nodePose0, nodePose1, nodePose2, param0, param1, 1 - param0 - param1);
 		else
 			a3hierarchyNodePoseTriangularLERP_internal(nodePose_out, nodePose0, nodePose1, nodePose2, param0, param1, 1 - param0 - param1);
@@ -767,6 +1033,26 @@ extern inline int a3hierarchyNodePoseTriangularLERP(a3_HierarchyNodePose *nodePo
 	return -1;
 }
 
+// add weighted additive layer to single node pose
+extern inline int a3hierarchyNodePoseAddLayer(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose, const a3_HierarchyNodePose *layerNodePose, const float weight, const a3_HierarchyPoseFlag flag)
+{
+	if (nodePose_out && nodePose && layerNodePose)
+	{
+		// full weight is a plain concat; skip scaling
+		if (weight >= 1.0f)
+			return a3hierarchyNodePoseConcat(nodePose_out, nodePose, layerNodePose, flag);
+
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyNodePoseAddLayer_quaternion_fast_internal(nodePose_out, nodePose, layerNodePose, weight);
+		else if (flag & a3poseFlag_quat)
+			a3hierarchyNodePoseAddLayer_quaternion_internal(nodePose_out, nodePose, layerNodePose, weight);
+		else
+			a3hierarchyNodePoseAddLayer_internal(nodePose_out, nodePose, layerNodePose, weight);
+		return 1;
+	}
+	return -1;
+}
+
 // convert single node pose to matrix
 extern inline int a3hierarchyNodePoseConvert(p3mat4 *mat_out, const a3_HierarchyNodePose *nodePose, const a3_HierarchyPoseFlag flag)
 {
@@ -775,7 +1061,8 @@ extern inline int a3hierarchyNodePoseConvert(p3mat4 *mat_out, const a3_Hierarchy
 	//	probably start with revolute (rotating) transforms
 	if (mat_out && nodePose)
 	{
-		switch (flag)
+		// (interpolation mode does not affect conversion)
+		switch (flag & ~a3poseFlag_slerp_fast)
 		{
 			// pure cases
 		case (a3poseFlag_rotate_q):
@@ -879,7 +1166,9 @@ extern inline int a3hierarchyPoseLERP(const a3_HierarchyPose *pose_out, const a3
 {
 	if (pose_out && pose0 && pose1 && pose_out->nodePose && pose0->nodePose && pose1->nodePose)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyPoseLERP_quaternion_fast_internal(pose_out, pose0, pose1, param, nodeCount);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyPoseLERP_quaternion_internal(pose_out, pose0, pose1, param, nodeCount);
 		else
 			a3hierarchyPoseLERP_internal(pose_out, pose0, pose1, param, nodeCount);
@@ -909,7 +1198,9 @@ extern inline int a3hierarchyPoseScale(const a3_HierarchyPose *pose_out, const a
 {
 	if (pose_out && poseScale && pose_out->nodePose && poseScale->nodePose)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyPoseScale_quaternion_fast_internal(pose_out, poseScale, param, nodeCount);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyPoseScale_quaternion_internal(pose_out, poseScale, param, nodeCount);
 		else
 			a3hierarchyPoseScale_internal(pose_out, poseScale, param, nodeCount);
@@ -924,7 +1215,9 @@ extern inline int a3hierarchyPoseBlend(const a3_HierarchyPose *pose_out, const a
 {
 	if (pose_out && pose0 && pose1 && pose_out->nodePose && pose0->nodePose && pose1->nodePose)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyPoseBlend_quaternion_fast_internal(pose_out, pose0, pose1, weight0, weight1, nodeCount);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyPoseBlend_quaternion_internal(pose_out, pose0, pose1, weight0, weight1, nodeCount);
 		else
 			a3hierarchyPoseBlend_internal(pose_out, pose0, pose1, weight0, weight1, nodeCount);
@@ -938,7 +1231,9 @@ extern inline int a3hierarchyPoseTriangularLERP(const a3_HierarchyPose *pose_out
 {
 	if (pose_out && pose0 && pose1 && pose2 && pose_out->nodePose && pose0->nodePose && pose1->nodePose && pose2->nodePose)
 	{
-		if (flag & a3poseFlag_quat)
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyPoseTriangularLERP_quaternion_fast_internal(pose_out, pose0, pose1, pose2, param0, param1, 1 - param0 - param1, nodeCount);
+		else if (flag & a3poseFlag_quat)
 			a3hierarchyPoseTriangularLERP_quaternion_internal(pose_out, pose0, pose1, pose2, param0, param1, 1 - param0 - param1, nodeCount);
 		else
 			a3hierarchyPoseTriangularLERP_internal(pose_out, pose0, pose1, pose2, param0, param1, 1 - param0 - param1, nodeCount);
@@ -947,12 +1242,33 @@ extern inline int a3hierarchyPoseTriangularLERP(const a3_HierarchyPose *pose_out
 	return -1;
 }
 
+// add weighted additive layer to full hierarchy pose
+extern inline int a3hierarchyPoseAddLayer(const a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose, const a3_HierarchyPose *layerPose, const float weight, const unsigned int nodeCount, const a3_HierarchyPoseFlag flag)
+{
+	if (pose_out && pose && layerPose && pose_out->nodePose && pose->nodePose && layerPose->nodePose)
+	{
+		// full weight is a plain concat; skip scaling
+		if (weight >= 1.0f)
+			return a3hierarchyPoseConcat(pose_out, pose, layerPose, nodeCount, flag);
+
+		if ((flag & a3poseFlag_quat) && (flag & a3poseFlag_slerp_fast))
+			a3hierarchyPoseAddLayer_quaternion_fast_internal(pose_out, pose, layerPose, weight, nodeCount);
+		else if (flag & a3poseFlag_quat)
+			a3hierarchyPoseAddLayer_quaternion_internal(pose_out, pose, layerPose, weight, nodeCount);
+		else
+			a3hierarchyPoseAddLayer_internal(pose_out, pose, layerPose, weight, nodeCount);
+		return nodeCount;
+	}
+	return -1;
+}
+
 // convert full hierarchy pose to hierarchy transforms
 extern inline int a3hierarchyPoseConvert(const a3_HierarchyTransform *transform_out, const a3_HierarchyPose *pose, const unsigned int nodeCount, const a3_HierarchyPoseFlag flag)
 {
 	if (transform_out && pose && transform_out->transform && pose->nodePose)
 	{
-		switch (flag)
+		// (interpolation mode does not affect conversion)
+		switch (flag & ~a3poseFlag_slerp_fast)
 		{
 			// pure cases
 		case (a3poseFlag_rotate_q):
@@ -1018,4 +1334,27 @@ extern inline int a3hierarchyPoseConvert(const a3_HierarchyTransform *transform_
 }
 
 
+// copy full set of hierarchy transforms
+extern inline int a3hierarchyTransformCopy(const a3_HierarchyTransform *transform_out, const a3_HierarchyTransform *copyTransform, const unsigned int nodeCount)
+{
+	if (transform_out && copyTransform && transform_out->transform && copyTransform->transform)
+	{
+		a3hierarchyTransformCopy_internal(transform_out, copyTransform, nodeCount);
+		return nodeCount;
+	}
+	return -1;
+}
+
+// LERP full set of hierarchy transforms
+extern inline int a3hierarchyTransformLERP(const a3_HierarchyTransform *transform_out, const a3_HierarchyTransform *transform0, const a3_HierarchyTransform *transform1, const float param, const unsigned int nodeCount)
+{
+	if (transform_out && transform0 && transform1 && transform_out->transform && transform0->transform && transform1->transform)
+	{
+		a3hierarchyTransformLERP_internal(transform_out, transform0, transform1, param, nodeCount);
+		return nodeCount;
+	}
+	return -1;
+}
+
+
 //-----------------------------------------------------------------------------
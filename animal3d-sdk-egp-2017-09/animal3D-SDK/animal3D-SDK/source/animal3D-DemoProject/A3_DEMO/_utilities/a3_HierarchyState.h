@@ -44,6 +44,7 @@ extern "C"
 	typedef struct a3_HierarchyTransform	a3_HierarchyTransform;
 	typedef struct a3_HierarchyPoseGroup	a3_HierarchyPoseGroup;
 	typedef struct a3_HierarchyState		a3_HierarchyState;
+	typedef struct a3_HierarchyPosePool		a3_HierarchyPosePool;
 	typedef enum a3_HierarchyPoseFlag		a3_HierarchyPoseFlag;
 #endif	// __cplusplus
 
@@ -119,6 +120,17 @@ extern "C"
 		// object transformations (relative to root's parent's space)
 		a3_HierarchyTransform objectSpace[1];
 	};
+
+
+	// bounded pool of scratch poses for intermediate blend results, shared 
+	//	by everything evaluated on one thread; poses live in a pose group 
+	//	and a stack of indices tracks which ones are free
+	struct a3_HierarchyPosePool
+	{
+		a3_HierarchyPoseGroup poseGroup[1];
+		unsigned int *freeIndex;
+		unsigned int freeCount;
+	};
 	
 
 //-----------------------------------------------------------------------------
@@ -131,6 +143,7 @@ extern "C"
 		a3poseFlag_rotate_q = 0x3,	// using quaternion for rotation
 		a3poseFlag_scale,			// using scale
 		a3poseFlag_translate = 0x8,	// using translation
+		a3poseFlag_slerp_fast = 0x10,	// with quaternion: approximate SLERP when blending
 	};
 	
 
@@ -148,6 +161,13 @@ extern "C"
 	// get offset to single node pose in contiguous set
 	inline int a3hierarchyPoseGroupGetNodePoseOffsetIndex(const a3_HierarchyPoseGroup *poseGroup, const unsigned int poseIndex, const unsigned int nodeIndex);
 
+	// convert Euler orientations (degrees, as used by a3poseFlag_rotate) in 
+	//	all poses of a group to unit quaternions for use with 
+	//	a3poseFlag_rotate_q; do this once after authoring key poses
+	// each node's orientation is sign-aligned with the same node in the 
+	//	previous pose so that consecutive keys blend along the short arc
+	inline int a3hierarchyPoseGroupConvertEulerToQuat(const a3_HierarchyPoseGroup *poseGroup);
+
 
 //-----------------------------------------------------------------------------
 
@@ -158,6 +178,22 @@ extern "C"
 	inline int a3hierarchyStateRelease(a3_HierarchyState *state);
 
 
+//-----------------------------------------------------------------------------
+
+	// create pool of scratch poses for hierarchy
+	inline int a3hierarchyPosePoolCreate(a3_HierarchyPosePool *pool_out, const a3_Hierarchy *hierarchy, const unsigned int poseCount);
+
+	// release pool
+	inline int a3hierarchyPosePoolRelease(a3_HierarchyPosePool *pool);
+
+	// take a pose from the pool (contents undefined)
+	//	return: index of pose in pool, or -1 if pool is exhausted
+	inline int a3hierarchyPosePoolAcquire(a3_HierarchyPosePool *pool, const a3_HierarchyPose **pose_out);
+
+	// give pose back to the pool
+	inline int a3hierarchyPosePoolReturn(a3_HierarchyPosePool *pool, const a3_HierarchyPose *pose);
+
+
 //-----------------------------------------------------------------------------
 
 	// reset single node pose
@@ -184,6 +220,10 @@ extern "C"
 	// triangular LERP single node pose
 	inline int a3hierarchyNodePoseTriangularLERP(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose0, const a3_HierarchyNodePose *nodePose1, const a3_HierarchyNodePose *nodePose2, const float param0, const float param1, const a3_HierarchyPoseFlag flag);
 
+	// add additive layer to single node pose: out = pose + layer * weight
+	//	(layer poses are deltas, e.g. keys of an additive clip)
+	inline int a3hierarchyNodePoseAddLayer(a3_HierarchyNodePose *nodePose_out, const a3_HierarchyNodePose *nodePose, const a3_HierarchyNodePose *layerNodePose, const float weight, const a3_HierarchyPoseFlag flag);
+
 	// convert single node pose to matrix
 	inline int a3hierarchyNodePoseConvert(p3mat4 *mat_out, const a3_HierarchyNodePose *nodePose, const a3_HierarchyPoseFlag flag);
 
@@ -212,10 +252,22 @@ extern "C"
 	// triangular LERP full hierarchy pose
 	inline int a3hierarchyPoseTriangularLERP(const a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose0, const a3_HierarchyPose *pose1, const a3_HierarchyPose *pose2, const float param0, const float param1, const unsigned int nodeCount, const a3_HierarchyPoseFlag flag);
 
+	// add additive layer to full hierarchy pose: out = pose + layer * weight
+	inline int a3hierarchyPoseAddLayer(const a3_HierarchyPose *pose_out, const a3_HierarchyPose *pose, const a3_HierarchyPose *layerPose, const float weight, const unsigned int nodeCount, const a3_HierarchyPoseFlag flag);
+
 	// convert full hierarchy pose to hierarchy transforms
 	inline int a3hierarchyPoseConvert(const a3_HierarchyTransform *transform_out, const a3_HierarchyPose *pose, const unsigned int nodeCount, const a3_HierarchyPoseFlag flag);
 
 
+	// copy full set of hierarchy transforms
+	inline int a3hierarchyTransformCopy(const a3_HierarchyTransform *transform_out, const a3_HierarchyTransform *copyTransform, const unsigned int nodeCount);
+
+	// LERP full set of hierarchy transforms component-wise
+	//	(cheap display interpolation between two nearby results, e.g. the 
+	//	last two fixed animation ticks; not a replacement for pose blending)
+	inline int a3hierarchyTransformLERP(const a3_HierarchyTransform *transform_out, const a3_HierarchyTransform *transform0, const a3_HierarchyTransform *transform1, const float param, const unsigned int nodeCount);
+
+
 //-----------------------------------------------------------------------------
 
 
@@ -0,0 +1,140 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_HierarchyStateBuffer.c
+	Implementation of triple-buffered hierarchy state.
+*/
+
+#include "a3_HierarchyStateBuffer.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif	// _MSC_VER
+
+
+//-----------------------------------------------------------------------------
+
+// flag on shared index meaning it holds unread data
+#define a3hierarchyStateBuffer_fresh	0x4
+#define a3hierarchyStateBuffer_index	0x3
+
+
+// atomic exchange with full barrier
+inline long a3hierarchyStateBufferExchange_internal(volatile long *dst, const long value)
+{
+#ifdef _MSC_VER
+	return _InterlockedExchange(dst, value);
+#else	// !_MSC_VER
+	return __atomic_exchange_n(dst, value, __ATOMIC_ACQ_REL);
+#endif	// _MSC_VER
+}
+
+
+//-----------------------------------------------------------------------------
+
+// create buffer
+extern inline int a3hierarchyStateBufferCreate(a3_HierarchyStateBuffer *buffer_out, const a3_HierarchyPoseGroup *poseGroup)
+{
+	if (buffer_out && poseGroup && poseGroup->hierarchy && !buffer_out->state->poseGroup)
+	{
+		const unsigned int nodeCount = poseGroup->hierarchy->numNodes;
+		unsigned int i;
+		for (i = 0; i < 3; ++i)
+		{
+			a3hierarchyStateCreate(buffer_out->state + i, poseGroup);
+			a3hierarchyPoseCopy(buffer_out->state[i].localPose, poseGroup->pose, nodeCount);
+		}
+
+		// writer starts on 0, reader on 1, 2 is in between with nothing new
+		buffer_out->writeIndex = 0;
+		buffer_out->readIndex = 1;
+		buffer_out->sharedIndex = 2;
+		buffer_out->publishCount = buffer_out->acquireCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// release buffer
+extern inline int a3hierarchyStateBufferRelease(a3_HierarchyStateBuffer *buffer)
+{
+	if (buffer && buffer->state->poseGroup)
+	{
+		unsigned int i;
+		for (i = 0; i < 3; ++i)
+			a3hierarchyStateRelease(buffer->state + i);
+		return 1;
+	}
+	return -1;
+}
+
+// get write state
+extern inline a3_HierarchyState *a3hierarchyStateBufferGetWrite(a3_HierarchyStateBuffer *buffer)
+{
+	if (buffer)
+		return (buffer->state + buffer->writeIndex);
+	return 0;
+}
+
+// publish
+extern inline int a3hierarchyStateBufferPublish(a3_HierarchyStateBuffer *buffer)
+{
+	if (buffer)
+	{
+		// hand over write state, take whatever was in between (may be a 
+		//	state the reader never saw, which is fine to overwrite)
+		const long prev = a3hierarchyStateBufferExchange_internal(&buffer->sharedIndex, 
+			(long)buffer->writeIndex | a3hierarchyStateBuffer_fresh);
+		buffer->writeIndex = (unsigned int)(prev & a3hierarchyStateBuffer_index);
+		return ++buffer->publishCount;
+	}
+	return -1;
+}
+
+// acquire
+extern inline int a3hierarchyStateBufferAcquire(a3_HierarchyStateBuffer *buffer)
+{
+	if (buffer)
+	{
+		// only the writer can change the shared index, and only to set the 
+		//	flag, so checking first is safe and avoids a needless swap
+		if (buffer->sharedIndex & a3hierarchyStateBuffer_fresh)
+		{
+			const long prev = a3hierarchyStateBufferExchange_internal(&buffer->sharedIndex, 
+				(long)buffer->readIndex);
+			buffer->readIndex = (unsigned int)(prev & a3hierarchyStateBuffer_index);
+			++buffer->acquireCount;
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+// get read state
+extern inline const a3_HierarchyState *a3hierarchyStateBufferGetRead(const a3_HierarchyStateBuffer *buffer)
+{
+	if (buffer)
+		return (buffer->state + buffer->readIndex);
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_HierarchyStateBuffer.h
+	Triple-buffered hierarchy state so that one thread can produce frame N+1 
+		while another consumes frame N. The writer fills the write state and 
+		publishes it; the reader acquires the latest published state and 
+		keeps reading it until the next acquire. Neither side ever blocks.
+*/
+
+#ifndef __ANIMAL3D_HIERARCHYSTATEBUFFER_H
+#define __ANIMAL3D_HIERARCHYSTATEBUFFER_H
+
+
+#include "a3_HierarchyState.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_HierarchyStateBuffer	a3_HierarchyStateBuffer;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// buffered hierarchy state
+	struct a3_HierarchyStateBuffer
+	{
+		// states: one being written, one being read, one in between
+		a3_HierarchyState state[3];
+
+		// index owned by writer, index owned by reader
+		unsigned int writeIndex, readIndex;
+
+		// index of the in-between state, with flag set if it is newer than 
+		//	what the reader has (only ever swapped atomically)
+		volatile long sharedIndex;
+
+		// number of publishes and acquires that got new data
+		unsigned int publishCount, acquireCount;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create buffer; all states start from the pose group's base pose
+	inline int a3hierarchyStateBufferCreate(a3_HierarchyStateBuffer *buffer_out, const a3_HierarchyPoseGroup *poseGroup);
+
+	// release buffer
+	inline int a3hierarchyStateBufferRelease(a3_HierarchyStateBuffer *buffer);
+
+	// writer: get state to fill for the next publish
+	inline a3_HierarchyState *a3hierarchyStateBufferGetWrite(a3_HierarchyStateBuffer *buffer);
+
+	// writer: publish the write state; returns new publish count
+	inline int a3hierarchyStateBufferPublish(a3_HierarchyStateBuffer *buffer);
+
+	// reader: take the latest published state, if any
+	//	return: 1 if a newer state was acquired
+	//	return: 0 if nothing new was published (read state unchanged)
+	//	return: -1 if invalid params
+	inline int a3hierarchyStateBufferAcquire(a3_HierarchyStateBuffer *buffer);
+
+	// reader: get the acquired state
+	inline const a3_HierarchyState *a3hierarchyStateBufferGetRead(const a3_HierarchyStateBuffer *buffer);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_HIERARCHYSTATEBUFFER_H
@@ -0,0 +1,321 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Inertializer.c
+	Implementation of inertialized pose transitions.
+*/
+
+#include "a3_Inertializer.h"
+
+#include "a3_Quaternion.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// offsets smaller than this (and not moving) are ignored
+#define a3inertializer_epsilon	0.0001f
+
+
+// fit quintic that starts at x0 with velocity v0 and reaches zero with 
+//	zero velocity and acceleration at t1; t1 is shortened if the initial 
+//	velocity would otherwise carry the offset past zero
+inline void a3inertializerFitQuintic_internal(float coeff_out[6], float *t1_inout, const float x0, const float v0)
+{
+	float t1 = *t1_inout, t1sq, a0;
+
+	if (v0 < 0.0f && x0 > 0.0f && -5.0f * x0 / v0 < t1)
+		t1 = -5.0f * x0 / v0;
+	if (t1 <= a3inertializer_epsilon)
+	{
+		memset(coeff_out, 0, 6 * sizeof(float));
+		*t1_inout = 0.0f;
+		return;
+	}
+
+	// initial acceleration should not push away from zero
+	t1sq = t1 * t1;
+	a0 = (-8.0f * v0 * t1 - 20.0f * x0) / t1sq;
+	if (a0 < 0.0f)
+		a0 = 0.0f;
+
+	coeff_out[0] = -(a0 * t1sq + 6.0f * v0 * t1 + 12.0f * x0) / (2.0f * t1sq * t1sq * t1);
+	coeff_out[1] = (3.0f * a0 * t1sq + 16.0f * v0 * t1 + 30.0f * x0) / (2.0f * t1sq * t1sq);
+	coeff_out[2] = -(3.0f * a0 * t1sq + 12.0f * v0 * t1 + 20.0f * x0) / (2.0f * t1sq * t1);
+	coeff_out[3] = 0.5f * a0;
+	coeff_out[4] = v0;
+	coeff_out[5] = x0;
+	*t1_inout = t1;
+}
+
+inline float a3inertializerEvalQuintic_internal(const float coeff[6], const float t1, const float t)
+{
+	return (t < t1) ? (((((coeff[0] * t + coeff[1]) * t + coeff[2]) * t + coeff[3]) * t + coeff[4]) * t + coeff[5]) : 0.0f;
+}
+
+// offset of a vector channel: magnitude and direction of (src - tgt), 
+//	velocity is the previous offset's change along that direction
+inline int a3inertializerBeginVector_internal(float coeff_out[6], float *t1_inout, p3vec4 *dir_out, const p3vec4 *src, const p3vec4 *srcPrev, const p3vec4 *tgt, const float dtInv)
+{
+	const float dx = src->x - tgt->x, dy = src->y - tgt->y, dz = src->z - tgt->z;
+	const float x0 = sqrtf(dx * dx + dy * dy + dz * dz);
+	float xPrev, lenInv;
+
+	if (x0 <= a3inertializer_epsilon)
+	{
+		*t1_inout = 0.0f;
+		return 0;
+	}
+	lenInv = 1.0f / x0;
+	dir_out->x = dx * lenInv;
+	dir_out->y = dy * lenInv;
+	dir_out->z = dz * lenInv;
+	dir_out->w = 0.0f;
+
+	xPrev = (srcPrev->x - tgt->x) * dir_out->x + (srcPrev->y - tgt->y) * dir_out->y + (srcPrev->z - tgt->z) * dir_out->z;
+	a3inertializerFitQuintic_internal(coeff_out, t1_inout, x0, (x0 - xPrev) * dtInv);
+	return (*t1_inout > 0.0f);
+}
+
+// offset of a rotation: angle and axis of (src * tgt^-1), velocity is 
+//	the previous offset's twist about that axis
+inline int a3inertializerBeginQuat_internal(float coeff_out[6], float *t1_inout, p3vec4 *axis_out, const p3vec4 *src, const p3vec4 *srcPrev, const p3vec4 *tgt, const float dtInv)
+{
+	p3vec4 tgtInv, offset, offsetPrev;
+	float s, x0, xPrev;
+
+	a3quatConjugate(tgtInv.v, tgt->v);
+	a3quatConcat(offset.v, src->v, tgtInv.v);
+	a3quatConcat(offsetPrev.v, srcPrev->v, tgtInv.v);
+
+	// short arc
+	if (offset.w < 0.0f)
+	{
+		offset.x = -offset.x;
+		offset.y = -offset.y;
+		offset.z = -offset.z;
+		offset.w = -offset.w;
+	}
+	if (offsetPrev.w < 0.0f)
+	{
+		offsetPrev.x = -offsetPrev.x;
+		offsetPrev.y = -offsetPrev.y;
+		offsetPrev.z = -offsetPrev.z;
+		offsetPrev.w = -offsetPrev.w;
+	}
+
+	s = sqrtf(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+	x0 = 2.0f * atan2f(s, offset.w);
+	if (x0 <= a3inertializer_epsilon)
+	{
+		*t1_inout = 0.0f;
+		return 0;
+	}
+	s = 1.0f / s;
+	axis_out->x = offset.x * s;
+	axis_out->y = offset.y * s;
+	axis_out->z = offset.z * s;
+	axis_out->w = 0.0f;
+
+	xPrev = 2.0f * atan2f(offsetPrev.x * axis_out->x + offsetPrev.y * axis_out->y + offsetPrev.z * axis_out->z, offsetPrev.w);
+	a3inertializerFitQuintic_internal(coeff_out, t1_inout, x0, (x0 - xPrev) * dtInv);
+	return (*t1_inout > 0.0f);
+}
+
+
+//-----------------------------------------------------------------------------
+
+// create inertializer
+extern inline int a3inertializerCreate(a3_Inertializer *inertializer_out, const a3_Hierarchy *hierarchy)
+{
+	if (inertializer_out && !inertializer_out->hierarchy && hierarchy && hierarchy->numNodes)
+	{
+		const unsigned int nodeCount = hierarchy->numNodes;
+		const unsigned int bytes = nodeCount * (2 * sizeof(a3_HierarchyNodePose) + sizeof(a3_InertializerNode) + sizeof(unsigned int));
+
+		inertializer_out->hierarchy = hierarchy;
+		inertializer_out->historyContiguous = (a3_HierarchyNodePose *)malloc(bytes);
+		memset(inertializer_out->historyContiguous, 0, bytes);
+		inertializer_out->history[0].nodePose = inertializer_out->historyContiguous;
+		inertializer_out->history[1].nodePose = inertializer_out->history[0].nodePose + nodeCount;
+		inertializer_out->node = (a3_InertializerNode *)(inertializer_out->history[1].nodePose + nodeCount);
+		inertializer_out->activeNode = (unsigned int *)(inertializer_out->node + nodeCount);
+		a3inertializerReset(inertializer_out);
+		return nodeCount;
+	}
+	return -1;
+}
+
+// release inertializer
+extern inline int a3inertializerRelease(a3_Inertializer *inertializer)
+{
+	if (inertializer && inertializer->hierarchy)
+	{
+		free(inertializer->historyContiguous);
+		memset(inertializer, 0, sizeof(a3_Inertializer));
+		return 1;
+	}
+	return -1;
+}
+
+// reset inertializer
+extern inline int a3inertializerReset(a3_Inertializer *inertializer)
+{
+	if (inertializer && inertializer->hierarchy)
+	{
+		inertializer->historyIndex = inertializer->historyCount = 0;
+		inertializer->activeCount = 0;
+		inertializer->time = inertializer->duration = 0.0f;
+		inertializer->flag = a3poseFlag_identity;
+		return 1;
+	}
+	return -1;
+}
+
+// begin transition
+extern inline int a3inertializerBegin(a3_Inertializer *inertializer, const a3_HierarchyPose *targetPose, const float duration, const float dt, const a3_HierarchyPoseFlag flag)
+{
+	if (inertializer && inertializer->hierarchy && targetPose && targetPose->nodePose && duration >= 0.0f && dt > 0.0f)
+	{
+		const unsigned int nodeCount = inertializer->hierarchy->numNodes;
+		const float dtInv = 1.0f / dt;
+		const a3_HierarchyNodePose *src, *srcPrev, *tgt = targetPose->nodePose;
+		a3_InertializerNode *node = inertializer->node;
+		unsigned int i, active;
+
+		inertializer->activeCount = 0;
+		inertializer->time = inertializer->duration = 0.0f;
+		inertializer->flag = flag;
+
+		// nothing to transition from yet
+		if (!inertializer->historyCount)
+			return 0;
+
+		// without a second output there is no velocity
+		src = inertializer->history[inertializer->historyIndex].nodePose;
+		srcPrev = inertializer->historyCount > 1 ? inertializer->history[1 - inertializer->historyIndex].nodePose : src;
+
+		for (i = 0; i < nodeCount; ++i, ++node, ++src, ++srcPrev, ++tgt)
+		{
+			node->rotationDuration = node->translationDuration = duration;
+			active = 0;
+
+			if (flag & a3poseFlag_rotate)
+			{
+				if ((flag & a3poseFlag_rotate_q) == a3poseFlag_rotate_q)
+					active |= a3inertializerBeginQuat_internal(node->rotation, &node->rotationDuration, &node->axis, &src->orientation, &srcPrev->orientation, &tgt->orientation, dtInv);
+				else
+					active |= a3inertializerBeginVector_internal(node->rotation, &node->rotationDuration, &node->axis, &src->orientation, &srcPrev->orientation, &tgt->orientation, dtInv);
+			}
+			else
+				node->rotationDuration = 0.0f;
+
+			if (flag & a3poseFlag_translate)
+				active |= a3inertializerBeginVector_internal(node->translation, &node->translationDuration, &node->direction, &src->translation, &srcPrev->translation, &tgt->translation, dtInv);
+			else
+				node->translationDuration = 0.0f;
+
+			if (active)
+			{
+				inertializer->activeNode[inertializer->activeCount++] = i;
+				if (node->rotationDuration > inertializer->duration)
+					inertializer->duration = node->rotationDuration;
+				if (node->translationDuration > inertializer->duration)
+					inertializer->duration = node->translationDuration;
+			}
+		}
+		return inertializer->activeCount;
+	}
+	return -1;
+}
+
+// apply transition and record output
+extern inline int a3inertializerApply(a3_Inertializer *inertializer, const a3_HierarchyPose *pose_inout, const float dt)
+{
+	if (inertializer && inertializer->hierarchy && pose_inout && pose_inout->nodePose)
+	{
+		const unsigned int nodeCount = inertializer->hierarchy->numNodes;
+		const unsigned int *activeNode = inertializer->activeNode, *const end = activeNode + inertializer->activeCount;
+		const a3_InertializerNode *node;
+		a3_HierarchyNodePose *nodePose;
+		p3vec4 correct;
+		float t, x, s;
+		int corrected = 0;
+
+		// offset was taken against the previous output, so first 
+		//	corrected output is one step into the decay
+		t = (inertializer->time += dt);
+		if (t < inertializer->duration)
+		{
+			for (; activeNode < end; ++activeNode)
+			{
+				node = inertializer->node + *activeNode;
+				nodePose = pose_inout->nodePose + *activeNode;
+
+				// rotation about offset axis, applied in parent's space
+				x = a3inertializerEvalQuintic_internal(node->rotation, node->rotationDuration, t);
+				if (x != 0.0f)
+				{
+					if ((inertializer->flag & a3poseFlag_rotate_q) == a3poseFlag_rotate_q)
+					{
+						s = sinf(0.5f * x);
+						correct.x = node->axis.x * s;
+						correct.y = node->axis.y * s;
+						correct.z = node->axis.z * s;
+						correct.w = cosf(0.5f * x);
+						a3quatConcat(nodePose->orientation.v, correct.v, nodePose->orientation.v);
+					}
+					else
+					{
+						nodePose->orientation.x += node->axis.x * x;
+						nodePose->orientation.y += node->axis.y * x;
+						nodePose->orientation.z += node->axis.z * x;
+					}
+				}
+
+				x = a3inertializerEvalQuintic_internal(node->translation, node->translationDuration, t);
+				if (x != 0.0f)
+				{
+					nodePose->translation.x += node->direction.x * x;
+					nodePose->translation.y += node->direction.y * x;
+					nodePose->translation.z += node->direction.z * x;
+				}
+			}
+			corrected = inertializer->activeCount;
+		}
+		else
+			inertializer->activeCount = 0;
+
+		// record output
+		inertializer->historyIndex = 1 - inertializer->historyIndex;
+		if (inertializer->historyCount < 2)
+			++inertializer->historyCount;
+		a3hierarchyPoseCopy(inertializer->history + inertializer->historyIndex, pose_inout, nodeCount);
+		return corrected;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Inertializer.h
+	Inertialization for pose transitions: instead of crossfading two clips, 
+		the offset and velocity between the old output and the new clip are 
+		recorded at the switch and decayed to zero per node with a quintic 
+		polynomial, so only the new clip is evaluated during the transition.
+*/
+
+#ifndef __ANIMAL3D_INERTIALIZER_H
+#define __ANIMAL3D_INERTIALIZER_H
+
+
+#include "a3_HierarchyState.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_InertializerNode	a3_InertializerNode;
+	typedef struct a3_Inertializer		a3_Inertializer;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// decaying offset for a single node
+	struct a3_InertializerNode
+	{
+		// unit axis of rotation offset and direction of translation offset
+		p3vec4 axis, direction;
+
+		// quintic coefficients of offset angle (radians, or degrees for 
+		//	Euler poses) and distance over time, highest power first
+		float rotation[6], translation[6];
+
+		// time at which each offset reaches zero (may be shorter than the 
+		//	requested duration to prevent overshoot)
+		float rotationDuration, translationDuration;
+	};
+
+	// inertialization state for one hierarchy
+	struct a3_Inertializer
+	{
+		const a3_Hierarchy *hierarchy;
+
+		// last two output poses, to find offset and velocity at switch
+		a3_HierarchyNodePose *historyContiguous;
+		a3_HierarchyPose history[2];
+		unsigned int historyIndex, historyCount;
+
+		// per-node offsets and list of nodes that have one
+		a3_InertializerNode *node;
+		unsigned int *activeNode;
+		unsigned int activeCount;
+
+		// time since switch and longest node duration
+		float time, duration;
+
+		// pose components in use for the current transition
+		a3_HierarchyPoseFlag flag;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create inertializer for hierarchy
+	inline int a3inertializerCreate(a3_Inertializer *inertializer_out, const a3_Hierarchy *hierarchy);
+
+	// release inertializer
+	inline int a3inertializerRelease(a3_Inertializer *inertializer);
+
+	// forget output history and any transition in progress (e.g. teleport)
+	inline int a3inertializerReset(a3_Inertializer *inertializer);
+
+	// begin transition: targetPose is the new source's output for this 
+	//	tick; offsets are taken from the last recorded output and velocities 
+	//	from the last two (dt is the time between recorded outputs)
+	// returns number of nodes with an offset to decay
+	inline int a3inertializerBegin(a3_Inertializer *inertializer, const a3_HierarchyPose *targetPose, const float duration, const float dt, const a3_HierarchyPoseFlag flag);
+
+	// advance transition and add remaining offsets to the current output, 
+	//	then record the result; call every tick, transition or not
+	// returns number of nodes corrected (zero if none, i.e. the pose is 
+	//	unchanged and does not need to be converted again)
+	inline int a3inertializerApply(a3_Inertializer *inertializer, const a3_HierarchyPose *pose_inout, const float dt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_INERTIALIZER_H
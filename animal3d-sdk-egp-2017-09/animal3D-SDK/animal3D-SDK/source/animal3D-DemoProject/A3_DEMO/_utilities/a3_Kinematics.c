@@ -26,6 +26,381 @@
 
 #include "a3_Quaternion.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if (defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1) || defined __SSE__)
+#define A3_KINEMATICS_SSE
+#include <xmmintrin.h>
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+
+// angle conversion (quaternion functions take degrees)
+#define a3kinematics_rad2deg	57.2957795131f
+
+
+// check that node is a descendant of (or the same as) ancestor
+inline int a3kinematicsIsDescendant_internal(const a3_Hierarchy *hierarchy, int nodeIndex, const int ancestorIndex)
+{
+	// parents always come before children, so stop once above ancestor
+	while (nodeIndex > ancestorIndex)
+		nodeIndex = hierarchy->nodes[nodeIndex].parentIndex;
+	return (nodeIndex == ancestorIndex);
+}
+
+// transform object-space direction into a node's parent space and 
+//	normalize it (rotation only; roots use object space directly)
+inline int a3kinematicsDirectionToParent_internal(p3real3p v_out, const a3_HierarchyState *hierarchyState, const unsigned int nodeIndex, const p3real3p v)
+{
+	const int parentIndex = hierarchyState->poseGroup->hierarchy->nodes[nodeIndex].parentIndex;
+	p3real3 tmp;
+	p3real lenSq;
+	if (parentIndex >= 0)
+	{
+		// inverse of rotation is its transpose: dot with each basis column
+		const p3mat4 *parentMat = hierarchyState->objectSpace->transform + parentIndex;
+		tmp[0] = p3real3Dot(parentMat->v0.v, v);
+		tmp[1] = p3real3Dot(parentMat->v1.v, v);
+		tmp[2] = p3real3Dot(parentMat->v2.v, v);
+	}
+	else
+		p3real3Set(tmp, v[0], v[1], v[2]);
+
+	lenSq = p3real3LengthSquared(tmp);
+	if (lenSq > (p3real)1.0e-12)
+	{
+		p3real3ProductS(v_out, tmp, realOne / (p3real)sqrt(lenSq));
+		return 1;
+	}
+	return 0;
+}
+
+// apply parent-space rotation to node's local orientation, then update 
+//	local matrix
+inline void a3kinematicsRotateLocalDelta_internal(const a3_HierarchyState *hierarchyState, const unsigned int nodeIndex, const a3quatp delta, const a3_HierarchyPoseFlag flag)
+{
+	a3_HierarchyNodePose *nodePose = hierarchyState->localPose->nodePose + nodeIndex;
+	a3quatConcat(nodePose->orientation.v, delta, nodePose->orientation.v);
+	a3quatArrayNormalize(nodePose->orientation.v, nodePose->orientation.v, 1);
+	a3hierarchyNodePoseConvert(hierarchyState->localSpace->transform + nodeIndex, nodePose, flag);
+}
+
+// rotate node's local orientation so that parent-space direction v0 
+//	aligns with v1
+inline void a3kinematicsRotateLocal_internal(const a3_HierarchyState *hierarchyState, const unsigned int nodeIndex, const p3real3p v0_unit, const p3real3p v1_unit, const a3_HierarchyPoseFlag flag)
+{
+	a3quat delta;
+	a3quatCreateDelta(delta, v0_unit, v1_unit);
+	a3kinematicsRotateLocalDelta_internal(hierarchyState, nodeIndex, delta, flag);
+}
+
+// two-bone solve without validation
+//	(writes base and mid local poses; does not solve FK)
+inline int a3kinematicsSolveInverseTwoBone_internal(const a3_HierarchyState *hierarchyState, const a3_KinematicsChainTwoBone *chain, const p3real3p target, const p3real3p pole_opt, const a3_HierarchyPoseFlag flag)
+{
+	const p3mat4 *objectSpace = hierarchyState->objectSpace->transform;
+	const p3real *posBase = objectSpace[chain->baseIndex].v3.v;
+	const p3real *posMid = objectSpace[chain->midIndex].v3.v;
+	const p3real *posEnd = objectSpace[chain->endIndex].v3.v;
+	p3real3 baseToMid, midToEnd, baseToTarget, bend, baseToMidNew, midToEndNew, v0, v1;
+	p3real len0, len1, dist, distMin, distMax, cosBase, sinBase, tmp;
+	a3quat rotBase;
+	int reached = 1;
+
+	// bone lengths stay fixed, only directions change
+	p3real3Diff(baseToMid, posMid, posBase);
+	p3real3Diff(midToEnd, posEnd, posMid);
+	p3real3Diff(baseToTarget, target, posBase);
+	len0 = (p3real)sqrt(p3real3LengthSquared(baseToMid));
+	len1 = (p3real)sqrt(p3real3LengthSquared(midToEnd));
+	dist = (p3real)sqrt(p3real3LengthSquared(baseToTarget));
+	if (len0 <= (p3real)1.0e-6 || len1 <= (p3real)1.0e-6)
+		return 0;
+
+	// clamp target distance to what the chain can reach, backing off 
+	//	slightly from fully straight so the bend direction stays defined
+	tmp = (p3real)1.0e-4 * (len0 + len1);
+	distMax = len0 + len1 - tmp;
+	distMin = (len0 > len1 ? len0 - len1 : len1 - len0) + tmp;
+	if (dist > distMax || dist < distMin)
+		reached = 0;
+	if (dist > (p3real)1.0e-6)
+		p3real3MulS(baseToTarget, realOne / dist);
+	else
+		p3real3ProductS(baseToTarget, baseToMid, realOne / len0);
+	dist = clamp(distMin, distMax, dist);
+
+	// bend direction: pole (or current mid) made perpendicular to target axis
+	if (pole_opt)
+		p3real3Diff(bend, pole_opt, posBase);
+	else
+		p3real3Set(bend, baseToMid[0], baseToMid[1], baseToMid[2]);
+	tmp = p3real3Dot(bend, baseToTarget);
+	p3real3Set(bend, bend[0] - baseToTarget[0] * tmp, bend[1] - baseToTarget[1] * tmp, bend[2] - baseToTarget[2] * tmp);
+	tmp = p3real3LengthSquared(bend);
+	if (tmp <= (p3real)1.0e-12)
+	{
+		// degenerate: any direction perpendicular to target axis
+		if (baseToTarget[0] * baseToTarget[0] < (p3real)0.5)
+			p3real3Set(bend, realZero, baseToTarget[2], -baseToTarget[1]);
+		else
+			p3real3Set(bend, -baseToTarget[2], realZero, baseToTarget[0]);
+		tmp = p3real3LengthSquared(bend);
+	}
+	p3real3MulS(bend, realOne / (p3real)sqrt(tmp));
+
+	// law of cosines gives angle at base; new mid lies in the bend plane
+	cosBase = (len0 * len0 + dist * dist - len1 * len1) / ((p3real)2.0 * len0 * dist);
+	cosBase = clamp(-realOne, realOne, cosBase);
+	sinBase = (p3real)sqrt(realOne - cosBase * cosBase);
+	p3real3Set(baseToMidNew,
+		len0 * (baseToTarget[0] * cosBase + bend[0] * sinBase),
+		len0 * (baseToTarget[1] * cosBase + bend[1] * sinBase),
+		len0 * (baseToTarget[2] * cosBase + bend[2] * sinBase));
+	p3real3Set(midToEndNew,
+		baseToTarget[0] * dist - baseToMidNew[0],
+		baseToTarget[1] * dist - baseToMidNew[1],
+		baseToTarget[2] * dist - baseToMidNew[2]);
+
+	// base: rotate current mid direction onto new one, in base parent space
+	a3kinematicsDirectionToParent_internal(v0, hierarchyState, chain->baseIndex, baseToMid);
+	a3kinematicsDirectionToParent_internal(v1, hierarchyState, chain->baseIndex, baseToMidNew);
+	a3kinematicsRotateLocal_internal(hierarchyState, chain->baseIndex, v0, v1, flag);
+
+	// mid: everything below base turned with it, so undo that turn on the 
+	//	new direction and work with the old (still valid) object matrices
+	p3real3MulS(baseToMid, realOne / len0);
+	p3real3MulS(baseToMidNew, realOne / len0);
+	a3quatCreateDelta(rotBase, baseToMid, baseToMidNew);
+	a3quatConjugate(rotBase, rotBase);
+	a3quatRotateVec3(midToEndNew, rotBase, midToEndNew);
+	a3kinematicsDirectionToParent_internal(v0, hierarchyState, chain->midIndex, midToEnd);
+	a3kinematicsDirectionToParent_internal(v1, hierarchyState, chain->midIndex, midToEndNew);
+	a3kinematicsRotateLocal_internal(hierarchyState, chain->midIndex, v0, v1, flag);
+
+	return reached;
+}
+
+// validate two-bone chain against hierarchy
+inline int a3kinematicsChainTwoBoneValid_internal(const a3_Hierarchy *hierarchy, const a3_KinematicsChainTwoBone *chain)
+{
+	return (chain->endIndex < hierarchy->numNodes && 
+		chain->baseIndex < chain->midIndex && chain->midIndex < chain->endIndex &&
+		a3kinematicsIsDescendant_internal(hierarchy, chain->midIndex, chain->baseIndex) &&
+		a3kinematicsIsDescendant_internal(hierarchy, chain->endIndex, chain->midIndex));
+}
+
+// FK over a list of nodes in hierarchy order
+inline void a3kinematicsSolveForwardList_internal(const a3_HierarchyState *hierarchyState, const unsigned int *nodeIndex, const unsigned int count)
+{
+	const a3_HierarchyNode *nodes = hierarchyState->poseGroup->hierarchy->nodes;
+	const p3mat4 *localSpace = hierarchyState->localSpace->transform;
+	p3mat4 *objectSpace = hierarchyState->objectSpace->transform;
+	const unsigned int *const end = nodeIndex + count;
+	int parentIndex;
+	for (; nodeIndex < end; ++nodeIndex)
+	{
+		parentIndex = nodes[*nodeIndex].parentIndex;
+		if (parentIndex >= 0)
+			p3real4x4Product(objectSpace[*nodeIndex].m, objectSpace[parentIndex].m, localSpace[*nodeIndex].m);
+		else
+			objectSpace[*nodeIndex] = localSpace[*nodeIndex];
+	}
+}
+
+// FK over a list of nodes stored child first (e.g. an ancestor walk)
+inline void a3kinematicsSolveForwardListReverse_internal(const a3_HierarchyState *hierarchyState, const unsigned int *nodeIndex, unsigned int count)
+{
+	const a3_HierarchyNode *nodes = hierarchyState->poseGroup->hierarchy->nodes;
+	const p3mat4 *localSpace = hierarchyState->localSpace->transform;
+	p3mat4 *objectSpace = hierarchyState->objectSpace->transform;
+	int parentIndex;
+	while (count-- > 0)
+	{
+		parentIndex = nodes[nodeIndex[count]].parentIndex;
+		if (parentIndex >= 0)
+			p3real4x4Product(objectSpace[nodeIndex[count]].m, objectSpace[parentIndex].m, localSpace[nodeIndex[count]].m);
+		else
+			objectSpace[nodeIndex[count]] = localSpace[nodeIndex[count]];
+	}
+}
+
+// FK for everything a change at base can move: its subtree if an index 
+//	is available, otherwise every node from base to the end of the array
+inline void a3kinematicsSolveForwardBelow_internal(const a3_HierarchyState *hierarchyState, const a3_HierarchyIndex *hierarchyIndex_opt, const unsigned int baseIndex)
+{
+	if (hierarchyIndex_opt && hierarchyIndex_opt->order && hierarchyIndex_opt->hierarchy == hierarchyState->poseGroup->hierarchy)
+		a3kinematicsSolveForwardSubtree(hierarchyState, hierarchyIndex_opt, baseIndex);
+	else
+		a3kinematicsSolveForwardPartial(hierarchyState, baseIndex, hierarchyState->poseGroup->hierarchy->numNodes - baseIndex);
+}
+
+// distance between points
+inline p3real a3kinematicsDistance_internal(const p3real3p p0, const p3real3p p1)
+{
+	p3real3 d;
+	p3real3Diff(d, p1, p0);
+	return (p3real)sqrt(p3real3LengthSquared(d));
+}
+
+// place point at given distance from another, in the direction of a 
+//	third point (output may be the same as the third point)
+inline void a3kinematicsPlaceJoint_internal(p3real3p p_out, const p3real3p from, const p3real3p toward, const p3real length)
+{
+	p3real3 d;
+	p3real lenSq;
+	p3real3Diff(d, toward, from);
+	lenSq = p3real3LengthSquared(d);
+	if (lenSq > (p3real)1.0e-12)
+		p3real3MulS(d, length / (p3real)sqrt(lenSq));
+	p3real3Set(p_out, from[0] + d[0], from[1] + d[1], from[2] + d[2]);
+}
+
+// validate chain for iterative solve
+inline int a3kinematicsChainValid_internal(const a3_HierarchyState *hierarchyState, const a3_KinematicsChain *chain, const a3_HierarchyPoseFlag flag)
+{
+	return (hierarchyState && hierarchyState->poseGroup && chain && chain->nodeIndex &&
+		(flag & a3poseFlag_rotate_q) == a3poseFlag_rotate_q &&
+		chain->subtreeIndex[chain->subtreeCount - 1] < hierarchyState->poseGroup->hierarchy->numNodes);
+}
+
+// apply warm start if requested and available
+inline void a3kinematicsChainBegin_internal(const a3_HierarchyState *hierarchyState, const a3_KinematicsChain *chain, const int warmStart, const a3_HierarchyPoseFlag flag)
+{
+	if (warmStart && chain->warmStartValid)
+	{
+		const p3vec4 *orientation = chain->warmStart;
+		const unsigned int *nodeIndex = chain->nodeIndex, *const end = nodeIndex + chain->nodeCount;
+		a3_HierarchyNodePose *nodePose;
+		for (; nodeIndex < end; ++nodeIndex, ++orientation)
+		{
+			nodePose = hierarchyState->localPose->nodePose + *nodeIndex;
+			nodePose->orientation = *orientation;
+			a3hierarchyNodePoseConvert(hierarchyState->localSpace->transform + *nodeIndex, nodePose, flag);
+		}
+
+		// only the chain is needed while iterating
+		a3kinematicsSolveForwardList_internal(hierarchyState, chain->nodeIndex, chain->nodeCount);
+	}
+}
+
+// cross each of a joint's basis axes with a lever arm; output holds one 
+//	result per axis, 4 values apart
+//	(axes are not normalized: steps are taken along the same axes, so 
+//	any scale cancels out)
+#ifdef A3_KINEMATICS_SSE
+
+inline void a3kinematicsCrossBasis_internal(p3real *cross_out, const p3mat4 *basis, const p3real3p lever)
+{
+	// a x r = a.yzx * r.zxy - a.zxy * r.yzx
+	const __m128 r = _mm_set_ps(0.0f, lever[2], lever[1], lever[0]);
+	const __m128 r_yzx = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 0, 2, 1));
+	const __m128 r_zxy = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 a;
+	unsigned int i;
+	for (i = 0; i < 3; ++i, cross_out += 4)
+	{
+		a = _mm_loadu_ps(basis->m[i]);
+		_mm_storeu_ps(cross_out, _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), r_zxy),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)), r_yzx)));
+	}
+}
+
+#else	// !A3_KINEMATICS_SSE
+
+inline void a3kinematicsCrossBasis_internal(p3real *cross_out, const p3mat4 *basis, const p3real3p lever)
+{
+	const p3real *a;
+	unsigned int i;
+	for (i = 0; i < 3; ++i, cross_out += 4)
+	{
+		a = basis->m[i];
+		cross_out[0] = a[1] * lever[2] - a[2] * lever[1];
+		cross_out[1] = a[2] * lever[0] - a[0] * lever[2];
+		cross_out[2] = a[0] * lever[1] - a[1] * lever[0];
+	}
+}
+
+#endif	// A3_KINEMATICS_SSE
+
+// validate effector set for solve
+inline int a3kinematicsEffectorSetValid_internal(const a3_HierarchyState *hierarchyState, const a3_KinematicsEffectorSet *effectorSet, const a3_HierarchyPoseFlag flag)
+{
+	unsigned int k;
+	if (hierarchyState && hierarchyState->poseGroup && effectorSet && effectorSet->jointIndex &&
+		(flag & a3poseFlag_rotate_q) == a3poseFlag_rotate_q)
+	{
+		for (k = 0; k < effectorSet->effectorCount; ++k)
+			if (effectorSet->effectorIndex[k] >= hierarchyState->poseGroup->hierarchy->numNodes)
+				return 0;
+		return 1;
+	}
+	return 0;
+}
+
+// solve symmetric positive definite system in place using Cholesky 
+//	decomposition (lower triangle of matrix is overwritten)
+//	return: 0 if matrix is not positive definite
+inline int a3kinematicsSolveSPD_internal(p3real *m, p3real *x_inout, const unsigned int n)
+{
+	unsigned int i, j, k;
+	p3real sum;
+
+	// decompose: m = L * L^T
+	for (j = 0; j < n; ++j)
+	{
+		sum = m[j * n + j];
+		for (k = 0; k < j; ++k)
+			sum -= m[j * n + k] * m[j * n + k];
+		if (sum <= (p3real)1.0e-12)
+			return 0;
+		m[j * n + j] = sum = (p3real)sqrt(sum);
+		sum = realOne / sum;
+		for (i = j + 1; i < n; ++i)
+		{
+			p3real v = m[i * n + j];
+			for (k = 0; k < j; ++k)
+				v -= m[i * n + k] * m[j * n + k];
+			m[i * n + j] = v * sum;
+		}
+	}
+
+	// forward substitution (L * y = b), then backward (L^T * x = y)
+	for (i = 0; i < n; ++i)
+	{
+		sum = x_inout[i];
+		for (k = 0; k < i; ++k)
+			sum -= m[i * n + k] * x_inout[k];
+		x_inout[i] = sum / m[i * n + i];
+	}
+	for (i = n; i-- > 0; )
+	{
+		sum = x_inout[i];
+		for (k = i + 1; k < n; ++k)
+			sum -= m[k * n + i] * x_inout[k];
+		x_inout[i] = sum / m[i * n + i];
+	}
+	return 1;
+}
+
+// store warm start, update subtree and record result
+inline void a3kinematicsChainEnd_internal(const a3_HierarchyState *hierarchyState, a3_KinematicsChain *chain, const p3real3p target, const unsigned int iterations)
+{
+	p3vec4 *orientation = chain->warmStart;
+	const unsigned int *nodeIndex = chain->nodeIndex, *const end = nodeIndex + chain->nodeCount;
+	for (; nodeIndex < end; ++nodeIndex, ++orientation)
+		*orientation = hierarchyState->localPose->nodePose[*nodeIndex].orientation;
+	chain->warmStartValid = 1;
+
+	a3kinematicsSolveForwardList_internal(hierarchyState, chain->subtreeIndex, chain->subtreeCount);
+	chain->error = a3kinematicsDistance_internal(hierarchyState->objectSpace->transform[chain->nodeIndex[chain->nodeCount - 1]].v3.v, target);
+	chain->iterations = iterations;
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -69,6 +444,537 @@ extern inline int a3kinematicsSolveForwardPartial(const a3_HierarchyState *hiera
 	return -1;
 }
 
+// subtree FK solver
+extern inline int a3kinematicsSolveForwardSubtree(const a3_HierarchyState *hierarchyState, const a3_HierarchyIndex *hierarchyIndex, const unsigned int nodeIndex)
+{
+	if (hierarchyState && hierarchyState->poseGroup && hierarchyIndex && hierarchyIndex->order &&
+		hierarchyIndex->hierarchy == hierarchyState->poseGroup->hierarchy && nodeIndex < hierarchyIndex->nodeCount)
+	{
+		// depth-first order keeps parents ahead of children
+		const unsigned int first = hierarchyIndex->position[nodeIndex];
+		const unsigned int count = hierarchyIndex->subtreeEnd[nodeIndex] - first;
+		a3kinematicsSolveForwardList_internal(hierarchyState, hierarchyIndex->order + first, count);
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// two-bone IK solver
+extern inline int a3kinematicsSolveInverseTwoBone(const a3_HierarchyState *hierarchyState, const a3_KinematicsChainTwoBone *chain, const p3real3p target, const p3real3p pole_opt, const a3_HierarchyPoseFlag flag)
+{
+	if (hierarchyState && hierarchyState->poseGroup && chain && target &&
+		(flag & a3poseFlag_rotate_q) == a3poseFlag_rotate_q &&
+		a3kinematicsChainTwoBoneValid_internal(hierarchyState->poseGroup->hierarchy, chain))
+	{
+		// solve chain, then update everything that may depend on it
+		//	(nodes before the base are not affected)
+		const int reached = a3kinematicsSolveInverseTwoBone_internal(hierarchyState, chain, target, pole_opt, flag);
+		a3kinematicsSolveForwardBelow_internal(hierarchyState, chain->hierarchyIndex, chain->baseIndex);
+		return reached;
+	}
+	return -1;
+}
+
+// batched two-bone IK solver
+extern inline int a3kinematicsSolveInverseTwoBoneBatch(const a3_HierarchyState *hierarchyStateList, const a3_KinematicsChainTwoBone *chain, const p3vec4 *targetList, const p3vec4 *poleList_opt, const unsigned int count, const a3_HierarchyPoseFlag flag)
+{
+	if (hierarchyStateList && chain && targetList &&
+		(flag & a3poseFlag_rotate_q) == a3poseFlag_rotate_q)
+	{
+		const a3_HierarchyState *hierarchyState = hierarchyStateList, *const end = hierarchyState + count;
+		unsigned int reached = 0;
+
+		// chain is shared, so validate it once against the first hierarchy
+		if (count && !(hierarchyState->poseGroup && 
+			a3kinematicsChainTwoBoneValid_internal(hierarchyState->poseGroup->hierarchy, chain)))
+			return -1;
+
+		for (; hierarchyState < end; ++hierarchyState, ++targetList)
+		{
+			reached += (a3kinematicsSolveInverseTwoBone_internal(hierarchyState, chain, 
+				targetList->v, poleList_opt ? (poleList_opt++)->v : 0, flag) > 0);
+			a3kinematicsSolveForwardBelow_internal(hierarchyState, chain->hierarchyIndex, chain->baseIndex);
+		}
+		return reached;
+	}
+	return -1;
+}
+
+
+// create iterative IK chain
+extern inline int a3kinematicsChainCreate(a3_KinematicsChain *chain_out, const a3_Hierarchy *hierarchy, const unsigned int baseIndex, const unsigned int endIndex, const p3real tolerance, const unsigned int iterationBudget)
+{
+	if (chain_out && hierarchy && hierarchy->nodes && !chain_out->nodeIndex &&
+		baseIndex < endIndex && endIndex < hierarchy->numNodes &&
+		a3kinematicsIsDescendant_internal(hierarchy, endIndex, baseIndex))
+	{
+		unsigned int nodeCount = 1, subtreeCount = 1, i, j;
+		int nodeIndex;
+
+		// count chain by walking up from end, and subtree below base
+		for (nodeIndex = endIndex; nodeIndex != (int)baseIndex; nodeIndex = hierarchy->nodes[nodeIndex].parentIndex)
+			++nodeCount;
+		for (i = baseIndex + 1; i < hierarchy->numNodes; ++i)
+			subtreeCount += a3kinematicsIsDescendant_internal(hierarchy, i, baseIndex);
+
+		// single allocation, vectors first
+		chain_out->warmStart = (p3vec4 *)malloc(2 * nodeCount * sizeof(p3vec4) + (nodeCount + subtreeCount) * sizeof(unsigned int));
+		chain_out->position = chain_out->warmStart + nodeCount;
+		chain_out->nodeIndex = (unsigned int *)(chain_out->position + nodeCount);
+		chain_out->subtreeIndex = chain_out->nodeIndex + nodeCount;
+		chain_out->nodeCount = nodeCount;
+		chain_out->subtreeCount = subtreeCount;
+
+		// fill chain back to front, subtree in hierarchy order
+		for (nodeIndex = endIndex, i = nodeCount; i > 0; nodeIndex = hierarchy->nodes[nodeIndex].parentIndex)
+			chain_out->nodeIndex[--i] = nodeIndex;
+		chain_out->subtreeIndex[0] = baseIndex;
+		for (i = baseIndex + 1, j = 1; i < hierarchy->numNodes; ++i)
+			if (a3kinematicsIsDescendant_internal(hierarchy, i, baseIndex))
+				chain_out->subtreeIndex[j++] = i;
+
+		chain_out->warmStartValid = 0;
+		chain_out->tolerance = tolerance;
+		chain_out->iterationBudget = iterationBudget;
+		chain_out->error = realZero;
+		chain_out->iterations = 0;
+
+		// done
+		return nodeCount;
+	}
+	return -1;
+}
+
+// release iterative IK chain
+extern inline int a3kinematicsChainRelease(a3_KinematicsChain *chain)
+{
+	if (chain && chain->nodeIndex)
+	{
+		free(chain->warmStart);
+		chain->warmStart = chain->position = 0;
+		chain->nodeIndex = chain->subtreeIndex = 0;
+		chain->nodeCount = chain->subtreeCount = 0;
+		chain->warmStartValid = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// discard warm start
+extern inline int a3kinematicsChainResetWarmStart(a3_KinematicsChain *chain)
+{
+	if (chain && chain->nodeIndex)
+	{
+		chain->warmStartValid = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// CCD solver
+extern inline int a3kinematicsSolveInverseCCD(const a3_HierarchyState *hierarchyState, a3_KinematicsChain *chain, const p3real3p target, const int warmStart, const a3_HierarchyPoseFlag flag)
+{
+	if (a3kinematicsChainValid_internal(hierarchyState, chain, flag) && target)
+	{
+		const p3mat4 *objectSpace = hierarchyState->objectSpace->transform;
+		const unsigned int *nodeIndex = chain->nodeIndex, last = chain->nodeCount - 1;
+		const p3real *posJoint, *posEnd = objectSpace[nodeIndex[last]].v3.v;
+		p3real3 effector, toEffector, toTarget, v0, v1;
+		p3real lenEffector, lenTarget;
+		unsigned int iteration = 0, j;
+
+		a3kinematicsChainBegin_internal(hierarchyState, chain, warmStart, flag);
+		p3real3Set(effector, posEnd[0], posEnd[1], posEnd[2]);
+		while (a3kinematicsDistance_internal(effector, target) > chain->tolerance && iteration < chain->iterationBudget)
+		{
+			// sweep from effector toward base; turning a joint only moves 
+			//	its descendants, so the next joint's matrices are still valid 
+			//	and the effector can be tracked without FK
+			for (j = last; j-- > 0; )
+			{
+				posJoint = objectSpace[nodeIndex[j]].v3.v;
+				p3real3Diff(toEffector, effector, posJoint);
+				p3real3Diff(toTarget, target, posJoint);
+				lenEffector = (p3real)sqrt(p3real3LengthSquared(toEffector));
+				lenTarget = (p3real)sqrt(p3real3LengthSquared(toTarget));
+				if (lenEffector > (p3real)1.0e-6 && lenTarget > (p3real)1.0e-6 &&
+					a3kinematicsDirectionToParent_internal(v0, hierarchyState, nodeIndex[j], toEffector) &&
+					a3kinematicsDirectionToParent_internal(v1, hierarchyState, nodeIndex[j], toTarget))
+				{
+					a3kinematicsRotateLocal_internal(hierarchyState, nodeIndex[j], v0, v1, flag);
+					p3real3MulS(toTarget, lenEffector / lenTarget);
+					p3real3Set(effector, posJoint[0] + toTarget[0], posJoint[1] + toTarget[1], posJoint[2] + toTarget[2]);
+				}
+			}
+
+			// refresh chain once per sweep
+			a3kinematicsSolveForwardList_internal(hierarchyState, nodeIndex, chain->nodeCount);
+			p3real3Set(effector, posEnd[0], posEnd[1], posEnd[2]);
+			++iteration;
+		}
+
+		a3kinematicsChainEnd_internal(hierarchyState, chain, target, iteration);
+		return iteration;
+	}
+	return -1;
+}
+
+// FABRIK solver
+extern inline int a3kinematicsSolveInverseFABRIK(const a3_HierarchyState *hierarchyState, a3_KinematicsChain *chain, const p3real3p target, const int warmStart, const a3_HierarchyPoseFlag flag)
+{
+	if (a3kinematicsChainValid_internal(hierarchyState, chain, flag) && target)
+	{
+		const p3mat4 *objectSpace = hierarchyState->objectSpace->transform;
+		const unsigned int *nodeIndex = chain->nodeIndex, last = chain->nodeCount - 1;
+		p3vec4 *position = chain->position;
+		p3real3 base, v0, v1;
+		p3real reach = realZero;
+		unsigned int iteration = 0, k;
+
+		a3kinematicsChainBegin_internal(hierarchyState, chain, warmStart, flag);
+
+		// copy joint positions and measure bones
+		for (k = 0; k <= last; ++k)
+			p3real3Set(position[k].v, objectSpace[nodeIndex[k]].v3.x, objectSpace[nodeIndex[k]].v3.y, objectSpace[nodeIndex[k]].v3.z);
+		for (k = 0; k < last; ++k)
+			reach += position[k].w = a3kinematicsDistance_internal(position[k].v, position[k + 1].v);
+		p3real3Set(base, position[0].x, position[0].y, position[0].z);
+
+		if (a3kinematicsDistance_internal(position[last].v, target) > chain->tolerance && iteration < chain->iterationBudget)
+		{
+			if (a3kinematicsDistance_internal(base, target) >= reach)
+			{
+				// out of reach: straighten toward target, nothing to iterate
+				for (k = 0; k < last; ++k)
+					a3kinematicsPlaceJoint_internal(position[k + 1].v, position[k].v, target, position[k].w);
+				++iteration;
+			}
+			else do
+			{
+				// backward: pin end to target and pull joints toward it
+				p3real3Set(position[last].v, target[0], target[1], target[2]);
+				for (k = last; k-- > 0; )
+					a3kinematicsPlaceJoint_internal(position[k].v, position[k + 1].v, position[k].v, position[k].w);
+
+				// forward: pin base back in place and push joints out
+				p3real3Set(position[0].v, base[0], base[1], base[2]);
+				for (k = 0; k < last; ++k)
+					a3kinematicsPlaceJoint_internal(position[k + 1].v, position[k].v, position[k + 1].v, position[k].w);
+				++iteration;
+			} while (a3kinematicsDistance_internal(position[last].v, target) > chain->tolerance && iteration < chain->iterationBudget);
+
+			// turn joints from base to end so each bone points at its new 
+			//	position, refreshing matrices as parents change
+			for (k = 0; k < last; ++k)
+			{
+				a3kinematicsSolveForwardList_internal(hierarchyState, nodeIndex + k, 2);
+				p3real3Diff(v0, objectSpace[nodeIndex[k + 1]].v3.v, objectSpace[nodeIndex[k]].v3.v);
+				p3real3Diff(v1, position[k + 1].v, position[k].v);
+				if (a3kinematicsDirectionToParent_internal(v0, hierarchyState, nodeIndex[k], v0) &&
+					a3kinematicsDirectionToParent_internal(v1, hierarchyState, nodeIndex[k], v1))
+				{
+					a3kinematicsRotateLocal_internal(hierarchyState, nodeIndex[k], v0, v1, flag);
+					a3kinematicsSolveForwardList_internal(hierarchyState, nodeIndex + k, 1);
+				}
+			}
+		}
+
+		a3kinematicsChainEnd_internal(hierarchyState, chain, target, iteration);
+		return iteration;
+	}
+	return -1;
+}
+
+
+// create effector set
+extern inline int a3kinematicsEffectorSetCreate(a3_KinematicsEffectorSet *effectorSet_out, const a3_Hierarchy *hierarchy, const unsigned int baseIndex, const unsigned int *effectorIndexList, const unsigned int effectorCount, const p3real damping, const p3real tolerance, const unsigned int iterationBudget)
+{
+	if (effectorSet_out && hierarchy && hierarchy->nodes && !effectorSet_out->jointIndex && 
+		effectorIndexList && effectorCount && baseIndex < hierarchy->numNodes && damping >= realZero)
+	{
+		unsigned int jointCount = 0, i, j, k;
+		unsigned int rows = 3 * effectorCount, cols;
+		unsigned char *isJoint;
+		int nodeIndex;
+
+		for (k = 0; k < effectorCount; ++k)
+			if (effectorIndexList[k] <= baseIndex || effectorIndexList[k] >= hierarchy->numNodes ||
+				!a3kinematicsIsDescendant_internal(hierarchy, effectorIndexList[k], baseIndex))
+				return -1;
+
+		// mark everything between each effector and base
+		isJoint = (unsigned char *)malloc(hierarchy->numNodes);
+		memset(isJoint, 0, hierarchy->numNodes);
+		for (k = 0; k < effectorCount; ++k)
+			for (nodeIndex = hierarchy->nodes[effectorIndexList[k]].parentIndex; nodeIndex >= (int)baseIndex; nodeIndex = hierarchy->nodes[nodeIndex].parentIndex)
+				isJoint[nodeIndex] = 1;
+		for (i = baseIndex; i < hierarchy->numNodes; ++i)
+			jointCount += isJoint[i];
+		cols = 3 * jointCount;
+
+		// single allocation: reals, then indices, then flags
+		effectorSet_out->jacobian = (p3real *)malloc((rows * cols + rows * rows + rows + cols) * sizeof(p3real) +
+			(jointCount + effectorCount) * sizeof(unsigned int) + jointCount * effectorCount);
+		effectorSet_out->system = effectorSet_out->jacobian + rows * cols;
+		effectorSet_out->error = effectorSet_out->system + rows * rows;
+		effectorSet_out->step = effectorSet_out->error + rows;
+		effectorSet_out->jointIndex = (unsigned int *)(effectorSet_out->step + cols);
+		effectorSet_out->effectorIndex = effectorSet_out->jointIndex + jointCount;
+		effectorSet_out->jointMovesEffector = (unsigned char *)(effectorSet_out->effectorIndex + effectorCount);
+		effectorSet_out->jointCount = jointCount;
+		effectorSet_out->effectorCount = effectorCount;
+
+		for (i = baseIndex, j = 0; i < hierarchy->numNodes; ++i)
+			if (isJoint[i])
+			{
+				effectorSet_out->jointIndex[j] = i;
+				for (k = 0; k < effectorCount; ++k)
+					effectorSet_out->jointMovesEffector[j * effectorCount + k] = 
+						(unsigned char)a3kinematicsIsDescendant_internal(hierarchy, effectorIndexList[k], i);
+				++j;
+			}
+		memcpy(effectorSet_out->effectorIndex, effectorIndexList, effectorCount * sizeof(unsigned int));
+		free(isJoint);
+
+		effectorSet_out->damping = damping;
+		effectorSet_out->tolerance = tolerance;
+		effectorSet_out->iterationBudget = iterationBudget;
+		effectorSet_out->errorMax = realZero;
+		effectorSet_out->iterations = 0;
+		effectorSet_out->hierarchyIndex = 0;
+
+		// done
+		return jointCount;
+	}
+	return -1;
+}
+
+// release effector set
+extern inline int a3kinematicsEffectorSetRelease(a3_KinematicsEffectorSet *effectorSet)
+{
+	if (effectorSet && effectorSet->jointIndex)
+	{
+		free(effectorSet->jacobian);
+		effectorSet->jacobian = effectorSet->system = effectorSet->error = effectorSet->step = 0;
+		effectorSet->jointIndex = effectorSet->effectorIndex = 0;
+		effectorSet->jointMovesEffector = 0;
+		effectorSet->jointCount = effectorSet->effectorCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// DLS solver
+extern inline int a3kinematicsSolveInverseDLS(const a3_HierarchyState *hierarchyState, a3_KinematicsEffectorSet *effectorSet, const p3vec4 *targetList, const a3_HierarchyPoseFlag flag)
+{
+	if (a3kinematicsEffectorSetValid_internal(hierarchyState, effectorSet, flag) && targetList)
+	{
+		const p3mat4 *objectSpace = hierarchyState->objectSpace->transform;
+		const unsigned int jointCount = effectorSet->jointCount, effectorCount = effectorSet->effectorCount;
+		const unsigned int rows = 3 * effectorCount, cols = 3 * jointCount;
+		const unsigned int baseIndex = effectorSet->jointIndex[0];
+		const unsigned char *moves;
+		const p3real dampingSq = effectorSet->damping * effectorSet->damping;
+		p3real *jacobian = effectorSet->jacobian, *system = effectorSet->system;
+		p3real *error = effectorSet->error, *step = effectorSet->step;
+		p3real cross[12], errorSq, errorMaxSq, angle, sum;
+		p3real3 lever, axis;
+		a3quat delta;
+		const p3real *posJoint, *posEffector, *row0, *row1;
+		unsigned int iteration = 0, i, j, k, r, a;
+
+		for (;;)
+		{
+			// error vector and worst effector
+			for (k = 0, errorMaxSq = realZero; k < effectorCount; ++k)
+			{
+				posEffector = objectSpace[effectorSet->effectorIndex[k]].v3.v;
+				p3real3Diff(error + 3 * k, targetList[k].v, posEffector);
+				errorSq = p3real3LengthSquared(error + 3 * k);
+				errorMaxSq = maximum(errorMaxSq, errorSq);
+			}
+			if (errorMaxSq <= effectorSet->tolerance * effectorSet->tolerance || iteration >= effectorSet->iterationBudget)
+				break;
+
+			// Jacobian: column for axis a of joint j, rows for effector k, 
+			//	is the axis crossed with the lever from joint to effector
+			memset(jacobian, 0, rows * cols * sizeof(p3real));
+			for (j = 0, moves = effectorSet->jointMovesEffector; j < jointCount; ++j, moves += effectorCount)
+			{
+				posJoint = objectSpace[effectorSet->jointIndex[j]].v3.v;
+				for (k = 0; k < effectorCount; ++k)
+					if (moves[k])
+					{
+						p3real3Diff(lever, objectSpace[effectorSet->effectorIndex[k]].v3.v, posJoint);
+						a3kinematicsCrossBasis_internal(cross, objectSpace + effectorSet->jointIndex[j], lever);
+						for (r = 0; r < 3; ++r)
+							for (a = 0; a < 3; ++a)
+								jacobian[(3 * k + r) * cols + 3 * j + a] = cross[4 * a + r];
+					}
+			}
+
+			// system = J * J^T + damping^2 * I (symmetric, fill lower half)
+			for (i = 0, row0 = jacobian; i < rows; ++i, row0 += cols)
+			{
+				for (r = 0, row1 = jacobian; r <= i; ++r, row1 += cols)
+				{
+					for (a = 0, sum = realZero; a < cols; ++a)
+						sum += row0[a] * row1[a];
+					system[i * rows + r] = sum;
+				}
+				system[i * rows + i] += dampingSq;
+			}
+
+			// solve for y, then step = J^T * y
+			if (!a3kinematicsSolveSPD_internal(system, error, rows))
+				break;
+			for (a = 0; a < cols; ++a)
+			{
+				for (i = 0, sum = realZero; i < rows; ++i)
+					sum += jacobian[i * cols + a] * error[i];
+				step[a] = sum;
+			}
+
+			// turn each joint about its combined axis, expressed in its 
+			//	parent's space
+			for (j = 0; j < jointCount; ++j)
+			{
+				const p3mat4 *basis = objectSpace + effectorSet->jointIndex[j];
+				p3real3Set(axis,
+					basis->m[0][0] * step[3 * j] + basis->m[1][0] * step[3 * j + 1] + basis->m[2][0] * step[3 * j + 2],
+					basis->m[0][1] * step[3 * j] + basis->m[1][1] * step[3 * j + 1] + basis->m[2][1] * step[3 * j + 2],
+					basis->m[0][2] * step[3 * j] + basis->m[1][2] * step[3 * j + 1] + basis->m[2][2] * step[3 * j + 2]);
+				angle = (p3real)sqrt(p3real3LengthSquared(axis));
+				if (angle > (p3real)1.0e-7 &&
+					a3kinematicsDirectionToParent_internal(axis, hierarchyState, effectorSet->jointIndex[j], axis))
+				{
+					a3quatCreateAxisAngle(delta, axis, angle * a3kinematics_rad2deg);
+					a3kinematicsRotateLocalDelta_internal(hierarchyState, effectorSet->jointIndex[j], delta, flag);
+				}
+			}
+
+			// update everything below base for next iteration
+			a3kinematicsSolveForwardBelow_internal(hierarchyState, effectorSet->hierarchyIndex, baseIndex);
+			++iteration;
+		}
+
+		effectorSet->errorMax = (p3real)sqrt(errorMaxSq);
+		effectorSet->iterations = iteration;
+		return iteration;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// create lazy FK
+extern inline int a3kinematicsLazyFKCreate(a3_KinematicsLazyFK *lazyFK_out, const a3_HierarchyState *hierarchyState, const a3_HierarchyPoseFlag convertFlag)
+{
+	if (lazyFK_out && hierarchyState && hierarchyState->poseGroup && !lazyFK_out->hierarchyState)
+	{
+		const unsigned int nodeCount = hierarchyState->poseGroup->hierarchy->numNodes;
+		lazyFK_out->solvedStamp = (unsigned int *)malloc(2 * nodeCount * sizeof(unsigned int));
+		lazyFK_out->path = lazyFK_out->solvedStamp + nodeCount;
+		memset(lazyFK_out->solvedStamp, 0, nodeCount * sizeof(unsigned int));
+
+		// stamp zero means never solved
+		lazyFK_out->hierarchyState = hierarchyState;
+		lazyFK_out->convertFlag = convertFlag;
+		lazyFK_out->stamp = 1;
+		lazyFK_out->fullySolvedStamp = 0;
+		return nodeCount;
+	}
+	return -1;
+}
+
+// release lazy FK
+extern inline int a3kinematicsLazyFKRelease(a3_KinematicsLazyFK *lazyFK)
+{
+	if (lazyFK && lazyFK->hierarchyState)
+	{
+		free(lazyFK->solvedStamp);
+		lazyFK->solvedStamp = lazyFK->path = 0;
+		lazyFK->hierarchyState = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// invalidate lazy FK
+extern inline int a3kinematicsLazyFKInvalidate(a3_KinematicsLazyFK *lazyFK)
+{
+	if (lazyFK && lazyFK->hierarchyState)
+	{
+		// on wrap, clear stamps so nothing old looks current
+		if (++lazyFK->stamp == 0)
+		{
+			memset(lazyFK->solvedStamp, 0, lazyFK->hierarchyState->poseGroup->hierarchy->numNodes * sizeof(unsigned int));
+			lazyFK->stamp = 1;
+			lazyFK->fullySolvedStamp = 0;
+		}
+		return lazyFK->stamp;
+	}
+	return -1;
+}
+
+// lazy FK query
+extern inline int a3kinematicsSolveForwardLazy(a3_KinematicsLazyFK *lazyFK, const unsigned int nodeIndex)
+{
+	if (lazyFK && lazyFK->hierarchyState && nodeIndex < lazyFK->hierarchyState->poseGroup->hierarchy->numNodes)
+	{
+		const a3_HierarchyState *hierarchyState = lazyFK->hierarchyState;
+		const a3_HierarchyNode *nodes = hierarchyState->poseGroup->hierarchy->nodes;
+		const unsigned int stamp = lazyFK->stamp;
+		unsigned int *path = lazyFK->path, count = 0, i;
+		int index = nodeIndex;
+
+		if (lazyFK->fullySolvedStamp == stamp)
+			return 0;
+
+		// walk up until reaching a current node or passing the root
+		while (index >= 0 && lazyFK->solvedStamp[index] != stamp)
+		{
+			path[count++] = index;
+			index = nodes[index].parentIndex;
+		}
+
+		// solve back down from the top of the path
+		for (i = count; i > 0; --i)
+		{
+			index = path[i - 1];
+			if (lazyFK->convertFlag)
+				a3hierarchyNodePoseConvert(hierarchyState->localSpace->transform + index, 
+					hierarchyState->localPose->nodePose + index, lazyFK->convertFlag);
+			lazyFK->solvedStamp[index] = stamp;
+		}
+		if (count)
+			a3kinematicsSolveForwardListReverse_internal(hierarchyState, path, count);
+		return count;
+	}
+	return -1;
+}
+
+// lazy FK full solve
+extern inline int a3kinematicsSolveForwardLazyAll(a3_KinematicsLazyFK *lazyFK)
+{
+	if (lazyFK && lazyFK->hierarchyState)
+	{
+		const a3_HierarchyState *hierarchyState = lazyFK->hierarchyState;
+		const unsigned int nodeCount = hierarchyState->poseGroup->hierarchy->numNodes;
+		if (lazyFK->fullySolvedStamp == lazyFK->stamp)
+			return 0;
+		if (lazyFK->convertFlag)
+			a3hierarchyPoseConvert(hierarchyState->localSpace, hierarchyState->localPose, nodeCount, lazyFK->convertFlag);
+		lazyFK->fullySolvedStamp = lazyFK->stamp;
+		return a3kinematicsSolveForward(hierarchyState);
+	}
+	return -1;
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -27,6 +27,7 @@
 
 
 #include "a3_HierarchyState.h"
+#include "a3_HierarchyIndex.h"
 
 
 //-----------------------------------------------------------------------------
@@ -35,10 +36,107 @@
 extern "C"
 {
 #else	// !__cplusplus
-
+	typedef struct a3_KinematicsChainTwoBone	a3_KinematicsChainTwoBone;
+	typedef struct a3_KinematicsChain			a3_KinematicsChain;
+	typedef struct a3_KinematicsEffectorSet		a3_KinematicsEffectorSet;
+	typedef struct a3_KinematicsLazyFK			a3_KinematicsLazyFK;
 #endif	// __cplusplus
 
 
+//-----------------------------------------------------------------------------
+
+	// two-bone chain (e.g. hip-knee-ankle, shoulder-elbow-wrist)
+	//	each node must be a descendant of the one before it
+	struct a3_KinematicsChainTwoBone
+	{
+		unsigned int baseIndex, midIndex, endIndex;
+
+		// optional index of the same hierarchy: if set, FK after a solve 
+		//	covers only the base's subtree instead of every later node
+		const a3_HierarchyIndex *hierarchyIndex;
+	};
+
+	// joint chain for iterative IK (e.g. spine, tail, tentacle), holding 
+	//	node lists and per-chain solver state
+	struct a3_KinematicsChain
+	{
+		// chain nodes from base to end effector (each the parent of the next)
+		unsigned int *nodeIndex, nodeCount;
+
+		// base and all of its descendants in hierarchy order; these are the 
+		//	only nodes a solve touches
+		unsigned int *subtreeIndex, subtreeCount;
+
+		// local orientations from the last solve, used to warm start
+		p3vec4 *warmStart;
+		int warmStartValid;
+
+		// scratch positions for FABRIK (w holds length to next joint)
+		p3vec4 *position;
+
+		// stop once effector is within tolerance of target, or once the 
+		//	iteration budget is used up
+		p3real tolerance;
+		unsigned int iterationBudget;
+
+		// results of last solve: distance to target and iterations used
+		p3real error;
+		unsigned int iterations;
+	};
+
+	// set of effectors solved together with damped least squares (e.g. 
+	//	both hands and the head reaching from the pelvis)
+	struct a3_KinematicsEffectorSet
+	{
+		// joints that turn: every node between base and an effector, in 
+		//	hierarchy order (each has three degrees of freedom)
+		unsigned int *jointIndex, jointCount;
+
+		// effector nodes and whether each joint moves each effector 
+		//	(stored per joint, one entry per effector)
+		unsigned int *effectorIndex, effectorCount;
+		unsigned char *jointMovesEffector;
+
+		// workspace sized to the set: Jacobian (3 rows per effector by 
+		//	3 columns per joint), square system (3 per effector), error 
+		//	vector and joint step
+		p3real *jacobian, *system, *error, *step;
+
+		// damping (larger is steadier near singular poses but converges 
+		//	slower), tolerance and iteration budget
+		p3real damping, tolerance;
+		unsigned int iterationBudget;
+
+		// results of last solve: largest effector distance, iterations used
+		p3real errorMax;
+		unsigned int iterations;
+
+		// optional index of the same hierarchy (null after create): if 
+		//	set, FK between iterations covers only the base's subtree
+		const a3_HierarchyIndex *hierarchyIndex;
+	};
+
+	// on-demand FK for single-node queries: only the ancestors of a 
+	//	queried node are solved, and results are kept until invalidated
+	struct a3_KinematicsLazyFK
+	{
+		// state whose object space is filled in on demand
+		const a3_HierarchyState *hierarchyState;
+
+		// if not identity, local poses along the path are converted to 
+		//	local matrices with this flag; otherwise local matrices are 
+		//	assumed to be current
+		a3_HierarchyPoseFlag convertFlag;
+
+		// per-node stamp of when it was last solved, and current stamp 
+		//	(everything is current if fully solved at this stamp)
+		unsigned int *solvedStamp, stamp, fullySolvedStamp;
+
+		// scratch list for the ancestor walk
+		unsigned int *path;
+	};
+
+
 //-----------------------------------------------------------------------------
 
 	// forward kinematics solver given an initialized hierarchy state
@@ -47,9 +145,93 @@ extern "C"
 	// forward kinematics solver starting at a specified joint
 	inline int a3kinematicsSolveForwardPartial(const a3_HierarchyState *hierarchyState, const unsigned int firstIndex, const unsigned int nodeCount);
 
+	// forward kinematics solver for one node and its descendants only, 
+	//	walking the index's depth-first range
+	inline int a3kinematicsSolveForwardSubtree(const a3_HierarchyState *hierarchyState, const a3_HierarchyIndex *hierarchyIndex, const unsigned int nodeIndex);
+
 
 //-----------------------------------------------------------------------------
 
+	// analytic two-bone IK: rotates base and mid so that end reaches the 
+	//	object-space target, bending toward the pole point if provided 
+	//	(otherwise keeps the current bend plane); writes local poses and 
+	//	matrices for the chain, then solves FK for the base's subtree (or 
+	//	from the base onward if the chain has no hierarchy index)
+	// object space must be solved beforehand; local poses must use 
+	//	quaternion orientations (flag includes a3poseFlag_rotate_q)
+	//	return: 1 if target is within reach
+	//	return: 0 if out of reach (chain is stretched toward target)
+	//	return: -1 if invalid params
+	inline int a3kinematicsSolveInverseTwoBone(const a3_HierarchyState *hierarchyState, const a3_KinematicsChainTwoBone *chain, const p3real3p target, const p3real3p pole_opt, const a3_HierarchyPoseFlag flag);
+
+	// two-bone IK for a list of states sharing the same chain (e.g. one 
+	//	foot for every character in a crowd); targets and poles are stored 
+	//	as 4D vectors, one per state
+	//	return: number of targets reached, or -1 if invalid params
+	inline int a3kinematicsSolveInverseTwoBoneBatch(const a3_HierarchyState *hierarchyStateList, const a3_KinematicsChainTwoBone *chain, const p3vec4 *targetList, const p3vec4 *poleList_opt, const unsigned int count, const a3_HierarchyPoseFlag flag);
+
+
+	// create chain from base node to end node (end must be a descendant)
+	//	return: number of nodes in chain, or -1 if invalid params
+	inline int a3kinematicsChainCreate(a3_KinematicsChain *chain_out, const a3_Hierarchy *hierarchy, const unsigned int baseIndex, const unsigned int endIndex, const p3real tolerance, const unsigned int iterationBudget);
+
+	// release chain
+	inline int a3kinematicsChainRelease(a3_KinematicsChain *chain);
+
+	// discard warm start (e.g. after a teleport or animation cut)
+	inline int a3kinematicsChainResetWarmStart(a3_KinematicsChain *chain);
+
+	// iterative IK solvers: move chain end toward object-space target
+	// if warm starting, chain orientations from the last solve replace the 
+	//	current local poses before iterating; the result is stored for next 
+	//	time either way
+	// object space must be solved beforehand; local poses must use 
+	//	quaternion orientations (flag includes a3poseFlag_rotate_q)
+	//	return: number of iterations used (zero if already within tolerance)
+	//	return: -1 if invalid params
+	inline int a3kinematicsSolveInverseCCD(const a3_HierarchyState *hierarchyState, a3_KinematicsChain *chain, const p3real3p target, const int warmStart, const a3_HierarchyPoseFlag flag);
+	inline int a3kinematicsSolveInverseFABRIK(const a3_HierarchyState *hierarchyState, a3_KinematicsChain *chain, const p3real3p target, const int warmStart, const a3_HierarchyPoseFlag flag);
+
+
+	// create effector set; every effector must be a descendant of base
+	//	return: number of joints, or -1 if invalid params
+	inline int a3kinematicsEffectorSetCreate(a3_KinematicsEffectorSet *effectorSet_out, const a3_Hierarchy *hierarchy, const unsigned int baseIndex, const unsigned int *effectorIndexList, const unsigned int effectorCount, const p3real damping, const p3real tolerance, const unsigned int iterationBudget);
+
+	// release effector set
+	inline int a3kinematicsEffectorSetRelease(a3_KinematicsEffectorSet *effectorSet);
+
+	// damped least squares IK: move all effectors toward their object-space 
+	//	targets (one per effector); FK is re-solved for the base's subtree 
+	//	(or from the base onward without a hierarchy index) after each 
+	//	iteration
+	// object space must be solved beforehand; local poses must use 
+	//	quaternion orientations (flag includes a3poseFlag_rotate_q)
+	//	return: number of iterations used, or -1 if invalid params
+	inline int a3kinematicsSolveInverseDLS(const a3_HierarchyState *hierarchyState, a3_KinematicsEffectorSet *effectorSet, const p3vec4 *targetList, const a3_HierarchyPoseFlag flag);
+
+
+//-----------------------------------------------------------------------------
+
+	// create lazy FK for hierarchy state
+	inline int a3kinematicsLazyFKCreate(a3_KinematicsLazyFK *lazyFK_out, const a3_HierarchyState *hierarchyState, const a3_HierarchyPoseFlag convertFlag);
+
+	// release lazy FK
+	inline int a3kinematicsLazyFKRelease(a3_KinematicsLazyFK *lazyFK);
+
+	// discard all results (call once per frame, or whenever local poses 
+	//	or matrices change)
+	inline int a3kinematicsLazyFKInvalidate(a3_KinematicsLazyFK *lazyFK);
+
+	// make sure a node's object-space transform is current, solving only 
+	//	the part of its ancestor chain that is not
+	//	return: number of nodes solved (zero if already current)
+	//	return: -1 if invalid params
+	inline int a3kinematicsSolveForwardLazy(a3_KinematicsLazyFK *lazyFK, const unsigned int nodeIndex);
+
+	// solve the full hierarchy (e.g. when the character is rendered 
+	//	anyway) so that later queries are free
+	inline int a3kinematicsSolveForwardLazyAll(a3_KinematicsLazyFK *lazyFK);
+
 
 //-----------------------------------------------------------------------------
 
@@ -0,0 +1,497 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_MotionDatabase.c
+	Implementation of motion matching database and search.
+*/
+
+#include "a3_MotionDatabase.h"
+
+#include "a3_Kinematics.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+
+#if (defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1) || defined __SSE__)
+#define A3_MOTIONDATABASE_SSE
+#include <xmmintrin.h>
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+
+// features compared between checks for an early exit from a block
+#define a3motionDatabase_exitStride	8
+
+
+// express object-space point (or direction) in root's frame
+inline void a3motionDatabaseToRoot_internal(float *v_out, const p3mat4 *root, const float *v, const int isPoint)
+{
+	const float dx = v[0] - (isPoint ? root->v3.x : 0.0f);
+	const float dy = v[1] - (isPoint ? root->v3.y : 0.0f);
+	const float dz = v[2] - (isPoint ? root->v3.z : 0.0f);
+	v_out[0] = root->v0.x * dx + root->v0.y * dy + root->v0.z * dz;
+	v_out[1] = root->v1.x * dx + root->v1.y * dy + root->v1.z * dz;
+	v_out[2] = root->v2.x * dx + root->v2.y * dy + root->v2.z * dz;
+}
+
+// raw joint features from root frame, joint positions and previous 
+//	positions (backward difference, as a query can only look back)
+inline void a3motionDatabaseJointFeatures_internal(float *feature_out, const p3mat4 *root, const p3vec4 *position, const p3vec4 *positionPrev, const unsigned int jointCount, const float dtInv)
+{
+	float delta[3];
+	unsigned int j;
+	for (j = 0; j < jointCount; ++j, feature_out += 6, ++position, ++positionPrev)
+	{
+		a3motionDatabaseToRoot_internal(feature_out, root, position->v, 1);
+		delta[0] = (position->x - positionPrev->x) * dtInv;
+		delta[1] = (position->y - positionPrev->y) * dtInv;
+		delta[2] = (position->z - positionPrev->z) * dtInv;
+		a3motionDatabaseToRoot_internal(feature_out + 3, root, delta, 0);
+	}
+}
+
+inline void a3motionDatabaseNormalize_internal(const a3_MotionDatabase *database, float *feature_inout)
+{
+	unsigned int d;
+	for (d = 0; d < database->featureCount; ++d)
+		feature_inout[d] = (feature_inout[d] - database->featureOffset[d]) * database->featureScale[d];
+	for (; d < database->featureCountPadded; ++d)
+		feature_inout[d] = 0.0f;
+}
+
+// full cost of one frame
+inline float a3motionDatabaseCost_internal(const a3_MotionDatabase *database, const float *query, const unsigned int frame)
+{
+	const float *feature = database->feature + frame;
+	float cost = 0.0f, diff;
+	unsigned int d;
+	for (d = 0; d < database->featureCount; ++d, feature += database->frameCountPadded)
+	{
+		diff = *feature - query[d];
+		cost += diff * diff;
+	}
+	return cost;
+}
+
+
+#ifdef A3_MOTIONDATABASE_SSE
+
+inline float a3motionDatabaseSum_internal(__m128 v)
+{
+	v = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(v);
+}
+
+inline float a3motionDatabaseMin_internal(__m128 v)
+{
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	v = _mm_min_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtss_f32(v);
+}
+
+// smallest possible cost of any frame in block
+inline float a3motionDatabaseBlockBound_internal(const a3_MotionDatabase *database, const float *query, const unsigned int block)
+{
+	const float *blockMin = database->blockMin + block * database->featureCountPadded;
+	const float *blockMax = database->blockMax + block * database->featureCountPadded;
+	const __m128 zero = _mm_setzero_ps();
+	__m128 q, e, sum = zero;
+	unsigned int d;
+	for (d = 0; d < database->featureCountPadded; d += 4)
+	{
+		q = _mm_loadu_ps(query + d);
+		e = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(blockMin + d), q), _mm_sub_ps(q, _mm_loadu_ps(blockMax + d))), zero);
+		sum = _mm_add_ps(sum, _mm_mul_ps(e, e));
+	}
+	return a3motionDatabaseSum_internal(sum);
+}
+
+// costs of all frames in block, four at a time; returns zero if the 
+//	partial costs show that no frame in the block can beat the bound
+inline int a3motionDatabaseBlockCost_internal(float *cost_out, const a3_MotionDatabase *database, const float *query, const unsigned int block, const float bound)
+{
+	const float *feature = database->feature + block * a3motionDatabase_blockSize;
+	__m128 q, d0, d1, d2, d3, c0, c1, c2, c3;
+	unsigned int d;
+
+	c0 = c1 = c2 = c3 = _mm_setzero_ps();
+	for (d = 0; d < database->featureCount; ++d, feature += database->frameCountPadded)
+	{
+		q = _mm_set1_ps(query[d]);
+		d0 = _mm_sub_ps(_mm_loadu_ps(feature + 0), q);
+		d1 = _mm_sub_ps(_mm_loadu_ps(feature + 4), q);
+		d2 = _mm_sub_ps(_mm_loadu_ps(feature + 8), q);
+		d3 = _mm_sub_ps(_mm_loadu_ps(feature + 12), q);
+		c0 = _mm_add_ps(c0, _mm_mul_ps(d0, d0));
+		c1 = _mm_add_ps(c1, _mm_mul_ps(d1, d1));
+		c2 = _mm_add_ps(c2, _mm_mul_ps(d2, d2));
+		c3 = _mm_add_ps(c3, _mm_mul_ps(d3, d3));
+
+		// costs only grow
+		if ((d + 1) % a3motionDatabase_exitStride == 0 && 
+			a3motionDatabaseMin_internal(_mm_min_ps(_mm_min_ps(c0, c1), _mm_min_ps(c2, c3))) >= bound)
+			return 0;
+	}
+	_mm_storeu_ps(cost_out + 0, c0);
+	_mm_storeu_ps(cost_out + 4, c1);
+	_mm_storeu_ps(cost_out + 8, c2);
+	_mm_storeu_ps(cost_out + 12, c3);
+	return 1;
+}
+
+#else	// !A3_MOTIONDATABASE_SSE
+
+inline float a3motionDatabaseBlockBound_internal(const a3_MotionDatabase *database, const float *query, const unsigned int block)
+{
+	const float *blockMin = database->blockMin + block * database->featureCountPadded;
+	const float *blockMax = database->blockMax + block * database->featureCountPadded;
+	float sum = 0.0f, e;
+	unsigned int d;
+	for (d = 0; d < database->featureCount; ++d)
+	{
+		e = blockMin[d] - query[d];
+		if (e < query[d] - blockMax[d])
+			e = query[d] - blockMax[d];
+		if (e > 0.0f)
+			sum += e * e;
+	}
+	return sum;
+}
+
+inline int a3motionDatabaseBlockCost_internal(float *cost_out, const a3_MotionDatabase *database, const float *query, const unsigned int block, const float bound)
+{
+	const float *feature = database->feature + block * a3motionDatabase_blockSize;
+	float q, diff, costMin;
+	unsigned int d, i;
+
+	memset(cost_out, 0, a3motionDatabase_blockSize * sizeof(float));
+	for (d = 0; d < database->featureCount; ++d, feature += database->frameCountPadded)
+	{
+		q = query[d];
+		for (i = 0; i < a3motionDatabase_blockSize; ++i)
+		{
+			diff = feature[i] - q;
+			cost_out[i] += diff * diff;
+		}
+
+		// costs only grow
+		if ((d + 1) % a3motionDatabase_exitStride == 0)
+		{
+			for (i = 1, costMin = cost_out[0]; i < a3motionDatabase_blockSize; ++i)
+				if (cost_out[i] < costMin)
+					costMin = cost_out[i];
+			if (costMin >= bound)
+				return 0;
+		}
+	}
+	return 1;
+}
+
+#endif	// A3_MOTIONDATABASE_SSE
+
+
+//-----------------------------------------------------------------------------
+
+// create database
+extern inline int a3motionDatabaseCreate(a3_MotionDatabase *database_out, const a3_HierarchyPoseGroup *poseGroup, const a3_ClipGroup *clipGroup, const unsigned int *jointIndexList, const unsigned int jointCount, const unsigned int *trajectoryOffsetList, const unsigned int trajectoryCount, const float weight_opt[3], const a3_HierarchyPoseFlag flag)
+{
+	if (database_out && !database_out->feature && poseGroup && poseGroup->hierarchy && clipGroup && clipGroup->clips && 
+		jointIndexList && jointCount && jointCount <= a3motionDatabase_jointMax && 
+		(trajectoryOffsetList || !trajectoryCount) && trajectoryCount <= a3motionDatabase_trajectoryMax)
+	{
+		const unsigned int nodeCount = poseGroup->hierarchy->numNodes;
+		const unsigned int featureCount = jointCount * 6 + trajectoryCount * 3;
+		const unsigned int featureCountPadded = (featureCount + 3) & ~3u;
+		const float weightDefault[3] = { 1.0f, 1.0f, 1.0f };
+		const float *weight = weight_opt ? weight_opt : weightDefault;
+		const a3_Clip *clip;
+		a3_HierarchyState state[1] = { 0 };
+		p3mat4 *root;
+		p3vec4 *position;
+		p3vec4 cycle, ahead, rootNow, rootAhead;
+		float *raw, *feature, *blockMin, *blockMax, groupVariance[3], dtInv, cycleScale;
+		unsigned int frameCountPadded, blockCount, groupSize[3];
+		unsigned int frameCount, c, i, j, k, d, g, frame, prev, next, cycles;
+
+		// validate joints and count frames of absolute clips
+		for (j = 0; j < jointCount; ++j)
+			if (jointIndexList[j] >= nodeCount)
+				return -1;
+		for (c = frameCount = 0, clip = clipGroup->clips; c < clipGroup->clipCount; ++c, ++clip)
+			if (clip->poseMode == a3clipPose_absolute)
+			{
+				if (clip->last >= poseGroup->poseCount)
+					return -1;
+				frameCount += clip->count;
+			}
+		if (!frameCount)
+			return -1;
+		blockCount = (frameCount + a3motionDatabase_blockSize - 1) / a3motionDatabase_blockSize;
+		frameCountPadded = blockCount * a3motionDatabase_blockSize;
+
+		database_out->poseGroup = poseGroup;
+		database_out->clipGroup = clipGroup;
+		memcpy(database_out->jointIndex, jointIndexList, jointCount * sizeof(unsigned int));
+		database_out->jointCount = jointCount;
+		if (trajectoryCount)
+			memcpy(database_out->trajectoryOffset, trajectoryOffsetList, trajectoryCount * sizeof(unsigned int));
+		database_out->trajectoryCount = trajectoryCount;
+		database_out->featureCount = featureCount;
+		database_out->featureCountPadded = featureCountPadded;
+		database_out->frameCount = frameCount;
+		database_out->frameCountPadded = frameCountPadded;
+		database_out->blockCount = blockCount;
+
+		// one allocation for everything kept
+		database_out->feature = (float *)malloc((featureCount * frameCountPadded + 2 * featureCountPadded * (blockCount + 1)) * sizeof(float) + 
+			2 * frameCountPadded * sizeof(unsigned int));
+		database_out->featureOffset = database_out->feature + featureCount * frameCountPadded;
+		database_out->featureScale = database_out->featureOffset + featureCountPadded;
+		database_out->blockMin = database_out->featureScale + featureCountPadded;
+		database_out->blockMax = database_out->blockMin + featureCountPadded * blockCount;
+		database_out->frameClip = (unsigned int *)(database_out->blockMax + featureCountPadded * blockCount);
+		database_out->framePose = database_out->frameClip + frameCountPadded;
+
+		// workspace: root frame and joint positions of every frame, raw features
+		root = (p3mat4 *)malloc(frameCount * (sizeof(p3mat4) + jointCount * sizeof(p3vec4) + featureCount * sizeof(float)));
+		position = (p3vec4 *)(root + frameCount);
+		raw = (float *)(position + frameCount * jointCount);
+
+		// solve every frame
+		a3hierarchyStateCreate(state, poseGroup);
+		for (c = frame = 0, clip = clipGroup->clips; c < clipGroup->clipCount; ++c, ++clip)
+			if (clip->poseMode == a3clipPose_absolute)
+				for (k = 0; k < clip->count; ++k, ++frame)
+				{
+					database_out->frameClip[frame] = c;
+					database_out->framePose[frame] = clip->first + k;
+					a3hierarchyPoseCopy(state->localPose, poseGroup->pose + clip->first + k, nodeCount);
+					a3hierarchyPoseConvert(state->localSpace, state->localPose, nodeCount, flag);
+					a3kinematicsSolveForward(state);
+					root[frame] = state->objectSpace->transform[0];
+					for (j = 0; j < jointCount; ++j)
+						position[frame * jointCount + j] = state->objectSpace->transform[jointIndexList[j]].v3;
+				}
+		a3hierarchyStateRelease(state);
+
+		// raw features: velocity from the previous frame of the (looping) 
+		//	clip, trajectory from frames ahead; samples past the end of the 
+		//	clip are unwrapped by whole cycles, where a cycle moves the root 
+		//	by the first to last key displacement at the clip's average speed 
+		//	(same as root motion extraction), plus any extracted root motion
+		for (c = frame = 0, clip = clipGroup->clips; c < clipGroup->clipCount; ++c, ++clip)
+			if (clip->poseMode == a3clipPose_absolute)
+			{
+				cycleScale = clip->count > 1 ? (float)clip->count / (float)(clip->count - 1) : 0.0f;
+				cycle.x = (root[frame + clip->count - 1].v3.x - root[frame].v3.x) * cycleScale;
+				cycle.y = (root[frame + clip->count - 1].v3.y - root[frame].v3.y) * cycleScale;
+				cycle.z = (root[frame + clip->count - 1].v3.z - root[frame].v3.z) * cycleScale;
+				dtInv = clip->frameDuration > 0.0f ? clip->frameDurationInv : 0.0f;
+				for (k = 0; k < clip->count; ++k, ++frame)
+				{
+					prev = frame - k + (k + clip->count - 1) % clip->count;
+					a3motionDatabaseJointFeatures_internal(raw + frame * featureCount, root + frame, 
+						position + frame * jointCount, position + prev * jointCount, jointCount, dtInv);
+					if (clip->rootMotion)
+						a3clipSampleRootMotion(clip, &rootNow, (float)k * clip->frameDuration);
+					for (i = 0; i < trajectoryCount; ++i)
+					{
+						cycles = (k + trajectoryOffsetList[i]) / clip->count;
+						next = frame - k + (k + trajectoryOffsetList[i]) % clip->count;
+						ahead.x = root[next].v3.x + cycle.x * (float)cycles;
+						ahead.y = root[next].v3.y + cycle.y * (float)cycles;
+						ahead.z = root[next].v3.z + cycle.z * (float)cycles;
+						if (clip->rootMotion)
+						{
+							a3clipSampleRootMotion(clip, &rootAhead, (float)(k + trajectoryOffsetList[i]) * clip->frameDuration);
+							ahead.x += rootAhead.x - rootNow.x;
+							ahead.y += rootAhead.y - rootNow.y;
+							ahead.z += rootAhead.z - rootNow.z;
+						}
+						a3motionDatabaseToRoot_internal(raw + frame * featureCount + jointCount * 6 + i * 3, root + frame, ahead.v, 1);
+					}
+				}
+			}
+
+		// normalize: per-feature mean, per-group deviation so each group 
+		//	counts the same regardless of its size
+		memset(groupVariance, 0, sizeof(groupVariance));
+		memset(groupSize, 0, sizeof(groupSize));
+		for (d = 0; d < featureCount; ++d)
+		{
+			float mean = 0.0f, variance = 0.0f, diff;
+			for (frame = 0; frame < frameCount; ++frame)
+				mean += raw[frame * featureCount + d];
+			mean /= (float)frameCount;
+			for (frame = 0; frame < frameCount; ++frame)
+			{
+				diff = raw[frame * featureCount + d] - mean;
+				variance += diff * diff;
+			}
+			g = d < jointCount * 6 ? (d % 6) / 3 : 2;
+			groupVariance[g] += variance / (float)frameCount;
+			++groupSize[g];
+			database_out->featureOffset[d] = mean;
+		}
+		for (d = 0; d < featureCount; ++d)
+		{
+			g = d < jointCount * 6 ? (d % 6) / 3 : 2;
+			if (groupVariance[g] > FLT_EPSILON * (float)groupSize[g])
+				database_out->featureScale[d] = weight[g] / sqrtf(groupVariance[g] / (float)groupSize[g]);
+			else
+				database_out->featureScale[d] = weight[g];
+		}
+		for (; d < featureCountPadded; ++d)
+			database_out->featureOffset[d] = database_out->featureScale[d] = 0.0f;
+
+		// store normalized rows; padding repeats the last frame so it 
+		//	never beats the real one
+		for (frame = 0; frame < frameCountPadded; ++frame)
+		{
+			i = frame < frameCount ? frame : frameCount - 1;
+			if (frame >= frameCount)
+			{
+				database_out->frameClip[frame] = database_out->frameClip[i];
+				database_out->framePose[frame] = database_out->framePose[i];
+			}
+			for (d = 0, feature = database_out->feature + frame; d < featureCount; ++d, feature += frameCountPadded)
+				*feature = (raw[i * featureCount + d] - database_out->featureOffset[d]) * database_out->featureScale[d];
+		}
+		free(root);
+
+		// block bounds
+		for (i = 0, blockMin = database_out->blockMin, blockMax = database_out->blockMax; i < blockCount; 
+			++i, blockMin += featureCountPadded, blockMax += featureCountPadded)
+		{
+			for (d = 0; d < featureCount; ++d)
+			{
+				feature = database_out->feature + d * frameCountPadded + i * a3motionDatabase_blockSize;
+				blockMin[d] = blockMax[d] = feature[0];
+				for (k = 1; k < a3motionDatabase_blockSize; ++k)
+				{
+					if (feature[k] < blockMin[d])
+						blockMin[d] = feature[k];
+					else if (feature[k] > blockMax[d])
+						blockMax[d] = feature[k];
+				}
+			}
+			for (; d < featureCountPadded; ++d)
+				blockMin[d] = blockMax[d] = 0.0f;
+		}
+		return frameCount;
+	}
+	return -1;
+}
+
+// release database
+extern inline int a3motionDatabaseRelease(a3_MotionDatabase *database)
+{
+	if (database && database->feature)
+	{
+		free(database->feature);
+		memset(database, 0, sizeof(a3_MotionDatabase));
+		return 1;
+	}
+	return -1;
+}
+
+// make query
+extern inline int a3motionDatabaseMakeQuery(const a3_MotionDatabase *database, float *query_out, const a3_HierarchyState *state, const a3_HierarchyState *statePrev, const float dt, const p3vec4 *trajectoryList)
+{
+	if (database && database->feature && query_out && state && state->objectSpace->transform && 
+		statePrev && statePrev->objectSpace->transform && dt > 0.0f && (trajectoryList || !database->trajectoryCount))
+	{
+		const p3mat4 *root = state->objectSpace->transform;
+		const float dtInv = 1.0f / dt;
+		const p3vec4 *position, *positionPrev;
+		float delta[3];
+		unsigned int j, i;
+
+		// velocity from previous to current, in current root's frame
+		for (j = 0; j < database->jointCount; ++j)
+		{
+			position = &state->objectSpace->transform[database->jointIndex[j]].v3;
+			positionPrev = &statePrev->objectSpace->transform[database->jointIndex[j]].v3;
+			delta[0] = (position->x - positionPrev->x) * dtInv;
+			delta[1] = (position->y - positionPrev->y) * dtInv;
+			delta[2] = (position->z - positionPrev->z) * dtInv;
+			a3motionDatabaseToRoot_internal(query_out + j * 6, root, position->v, 1);
+			a3motionDatabaseToRoot_internal(query_out + j * 6 + 3, root, delta, 0);
+		}
+
+		// trajectory is already root-relative
+		for (i = 0; i < database->trajectoryCount; ++i)
+		{
+			query_out[database->jointCount * 6 + i * 3 + 0] = trajectoryList[i].x;
+			query_out[database->jointCount * 6 + i * 3 + 1] = trajectoryList[i].y;
+			query_out[database->jointCount * 6 + i * 3 + 2] = trajectoryList[i].z;
+		}
+		a3motionDatabaseNormalize_internal(database, query_out);
+		return database->featureCountPadded;
+	}
+	return -1;
+}
+
+// search
+extern inline int a3motionDatabaseSearch(const a3_MotionDatabase *database, const float *query, const int currentFrame, float *cost_out_opt)
+{
+	if (database && database->feature && query)
+	{
+		float cost[a3motionDatabase_blockSize], best = FLT_MAX;
+		int bestFrame = -1;
+		unsigned int block, i;
+
+		// current frame sets the first bound
+		if (currentFrame >= 0 && (unsigned int)currentFrame < database->frameCount)
+		{
+			best = a3motionDatabaseCost_internal(database, query, currentFrame);
+			bestFrame = currentFrame;
+		}
+
+		for (block = 0; block < database->blockCount; ++block)
+		{
+			if (a3motionDatabaseBlockBound_internal(database, query, block) >= best || 
+				!a3motionDatabaseBlockCost_internal(cost, database, query, block, best))
+				continue;
+			for (i = 0; i < a3motionDatabase_blockSize; ++i)
+				if (cost[i] < best)
+				{
+					best = cost[i];
+					bestFrame = block * a3motionDatabase_blockSize + i;
+				}
+		}
+
+		// padding repeats the last frame
+		if (bestFrame >= (int)database->frameCount)
+			bestFrame = database->frameCount - 1;
+		if (cost_out_opt)
+			*cost_out_opt = best;
+		return bestFrame;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_MotionDatabase.h
+	Motion matching database: every frame of the absolute clips in a group 
+		is described by a feature vector (root-relative joint positions and 
+		velocities, and future root positions), normalized and stored one 
+		feature per row so that a search compares four frames at once. 
+		Frames are grouped into blocks with feature bounds so that blocks 
+		that cannot beat the best match so far are skipped.
+*/
+
+#ifndef __ANIMAL3D_MOTIONDATABASE_H
+#define __ANIMAL3D_MOTIONDATABASE_H
+
+
+#include "a3_HierarchyState.h"
+#include "a3_ClipControl.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_MotionDatabase			a3_MotionDatabase;
+	typedef enum a3_MotionDatabaseMaxCounts		a3_MotionDatabaseMaxCounts;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fixed limits
+	enum a3_MotionDatabaseMaxCounts
+	{
+		a3motionDatabase_jointMax = 6,			// matched joints
+		a3motionDatabase_trajectoryMax = 4,		// future root samples
+		a3motionDatabase_blockSize = 16,		// frames per bounds block
+	};
+
+	// feature database
+	struct a3_MotionDatabase
+	{
+		const a3_HierarchyPoseGroup *poseGroup;
+		const a3_ClipGroup *clipGroup;
+
+		// joints whose root-relative position and velocity are matched
+		unsigned int jointIndex[a3motionDatabase_jointMax], jointCount;
+
+		// frames ahead (unwrapped past the end of the clip) at which root 
+		//	position is matched
+		unsigned int trajectoryOffset[a3motionDatabase_trajectoryMax], trajectoryCount;
+
+		// feature layout: position xyz then velocity xyz for each joint, 
+		//	then position xyz for each trajectory sample; queries and 
+		//	bounds are padded to a multiple of four
+		unsigned int featureCount, featureCountPadded;
+
+		// frames, padded to whole blocks; clip and pose index of each
+		unsigned int frameCount, frameCountPadded;
+		unsigned int *frameClip, *framePose;
+
+		// normalization (weights included): (raw - offset) * scale
+		float *featureOffset, *featureScale;
+
+		// normalized features: row of all frames for each feature
+		float *feature;
+
+		// per-block bounds of normalized features
+		unsigned int blockCount;
+		float *blockMin, *blockMax;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// build database from all absolute clips in group (additive clips are 
+	//	skipped); joint list and trajectory offsets are copied
+	// weight_opt scales position, velocity and trajectory features 
+	//	(null for equal weights)
+	// returns frame count
+	inline int a3motionDatabaseCreate(a3_MotionDatabase *database_out, const a3_HierarchyPoseGroup *poseGroup, const a3_ClipGroup *clipGroup, const unsigned int *jointIndexList, const unsigned int jointCount, const unsigned int *trajectoryOffsetList, const unsigned int trajectoryCount, const float weight_opt[3], const a3_HierarchyPoseFlag flag);
+
+	// release database
+	inline int a3motionDatabaseRelease(a3_MotionDatabase *database);
+
+	// build normalized query (featureCountPadded values) from a character's 
+	//	current and previous solved states, time between them and the 
+	//	desired future root positions relative to its current root
+	inline int a3motionDatabaseMakeQuery(const a3_MotionDatabase *database, float *query_out, const a3_HierarchyState *state, const a3_HierarchyState *statePrev, const float dt, const p3vec4 *trajectoryList);
+
+	// find frame closest to query; currentFrame (or negative for none) is 
+	//	the starting candidate, so continuing playback wins ties and gives 
+	//	the search a bound from the start
+	// returns frame index, or -1 if invalid
+	inline int a3motionDatabaseSearch(const a3_MotionDatabase *database, const float *query, const int currentFrame, float *cost_out_opt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_MOTIONDATABASE_H
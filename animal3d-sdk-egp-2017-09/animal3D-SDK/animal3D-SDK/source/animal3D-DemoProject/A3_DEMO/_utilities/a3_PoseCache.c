@@ -0,0 +1,216 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_PoseCache.c
+	Implementation of shared pose evaluation cache.
+*/
+
+#include "a3_PoseCache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// number of slots searched before replacing the least recently used
+#define a3poseCache_probeLength	8
+
+
+// hash key (FNV-1a over key members)
+inline unsigned int a3poseCacheHash_internal(const a3_PoseCacheKey *key)
+{
+	const unsigned int *k = (const unsigned int *)key, *const end = k + sizeof(a3_PoseCacheKey) / sizeof(unsigned int);
+	unsigned int hash = 2166136261u;
+	while (k < end)
+	{
+		hash ^= *(k++);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+inline int a3poseCacheKeyEqual_internal(const a3_PoseCacheKey *key0, const a3_PoseCacheKey *key1)
+{
+	return (key0->clipIndex == key1->clipIndex && key0->frameIndex == key1->frameIndex &&
+		key0->nextIndex == key1->nextIndex && key0->frameStep == key1->frameStep &&
+		key0->blendConfig == key1->blendConfig && key0->blendStep == key1->blendStep);
+}
+
+inline unsigned int a3poseCacheQuantize_internal(const float param, const unsigned int steps)
+{
+	// round to nearest step, clamped to valid range
+	const float scaled = param * (float)steps + 0.5f;
+	return (scaled <= 0.0f ? 0 : scaled >= (float)steps ? steps : (unsigned int)scaled);
+}
+
+
+//-----------------------------------------------------------------------------
+
+// create cache
+extern inline int a3poseCacheCreate(a3_PoseCache *cache_out, const a3_HierarchyPoseGroup *poseGroup, const unsigned int entryCount, const unsigned int quantizeSteps)
+{
+	if (cache_out && poseGroup && !cache_out->entry && poseGroup->hierarchy && entryCount && quantizeSteps)
+	{
+		unsigned int count = 1, i;
+		while (count < entryCount)
+			count <<= 1;
+
+		cache_out->entry = (a3_PoseCacheEntry *)malloc(count * sizeof(a3_PoseCacheEntry));
+		memset(cache_out->entry, 0, count * sizeof(a3_PoseCacheEntry));
+		for (i = 0; i < count; ++i)
+			a3hierarchyStateCreate(cache_out->entry[i].state, poseGroup);
+
+		cache_out->poseGroup = poseGroup;
+		cache_out->entryCount = count;
+		cache_out->entryMask = count - 1;
+		cache_out->quantizeSteps = quantizeSteps;
+		cache_out->quantizeStepsInv = 1.0f / (float)quantizeSteps;
+		cache_out->stamp = 0;
+		cache_out->hits = cache_out->misses = 0;
+		return count;
+	}
+	return -1;
+}
+
+// release cache
+extern inline int a3poseCacheRelease(a3_PoseCache *cache)
+{
+	if (cache && cache->entry)
+	{
+		unsigned int i;
+		for (i = 0; i < cache->entryCount; ++i)
+			a3hierarchyStateRelease(cache->entry[i].state);
+		free(cache->entry);
+		cache->entry = 0;
+		cache->poseGroup = 0;
+		cache->entryCount = cache->entryMask = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// invalidate all entries
+extern inline int a3poseCacheClear(a3_PoseCache *cache)
+{
+	if (cache && cache->entry)
+	{
+		unsigned int i;
+		for (i = 0; i < cache->entryCount; ++i)
+			cache->entry[i].stamp = 0;
+		cache->stamp = 0;
+		cache->hits = cache->misses = 0;
+		return cache->entryCount;
+	}
+	return -1;
+}
+
+// build key
+extern inline int a3poseCacheMakeKey(a3_PoseCacheKey *key_out, const a3_PoseCache *cache, const a3_ClipController *ctrl, const unsigned int blendConfig, const float blendParam)
+{
+	if (key_out && cache && ctrl)
+	{
+		key_out->clipIndex = ctrl->clipIndex;
+		key_out->frameIndex = ctrl->frameIndex;
+		key_out->nextIndex = ctrl->nextIndex;
+		key_out->frameStep = a3poseCacheQuantize_internal(ctrl->frameParam, cache->quantizeSteps);
+		key_out->blendConfig = blendConfig;
+		key_out->blendStep = a3poseCacheQuantize_internal(blendParam, cache->quantizeSteps);
+		return 1;
+	}
+	return -1;
+}
+
+// get frame param
+extern inline float a3poseCacheKeyGetFrameParam(const a3_PoseCache *cache, const a3_PoseCacheKey *key)
+{
+	return ((float)key->frameStep * cache->quantizeStepsInv);
+}
+
+// get blend param
+extern inline float a3poseCacheKeyGetBlendParam(const a3_PoseCache *cache, const a3_PoseCacheKey *key)
+{
+	return ((float)key->blendStep * cache->quantizeStepsInv);
+}
+
+// find or claim entry
+extern inline int a3poseCacheAcquire(a3_PoseCache *cache, const a3_PoseCacheKey *key, a3_HierarchyState **state_out)
+{
+	if (cache && cache->entry && key && state_out)
+	{
+		const unsigned int hash = a3poseCacheHash_internal(key);
+		a3_PoseCacheEntry *entry, *replace = 0;
+		unsigned int i;
+
+		// stamp zero is reserved for empty entries
+		if (++cache->stamp == 0)
+		{
+			a3poseCacheClear(cache);
+			cache->stamp = 1;
+		}
+
+		// probe for match, remember best slot to replace
+		for (i = 0; i < a3poseCache_probeLength && i < cache->entryCount; ++i)
+		{
+			entry = cache->entry + ((hash + i) & cache->entryMask);
+			if (entry->stamp && entry->hash == hash && a3poseCacheKeyEqual_internal(&entry->key, key))
+			{
+				entry->stamp = cache->stamp;
+				*state_out = entry->state;
+				++cache->hits;
+				return 1;
+			}
+			if (!replace || entry->stamp < replace->stamp)
+				replace = entry;
+		}
+
+		// miss: claim oldest slot in probe window
+		replace->key = *key;
+		replace->hash = hash;
+		replace->stamp = cache->stamp;
+		*state_out = replace->state;
+		++cache->misses;
+		return 0;
+	}
+	return -1;
+}
+
+// apply root offset
+extern inline int a3poseCacheApplyRootOffset(const a3_HierarchyTransform *transform_out, const a3_HierarchyState *cachedState, const p3mat4 *rootOffset_opt)
+{
+	if (transform_out && cachedState && transform_out->transform && cachedState->poseGroup)
+	{
+		const unsigned int nodeCount = cachedState->poseGroup->hierarchy->numNodes;
+		if (rootOffset_opt)
+		{
+			p3mat4 *mat_out = transform_out->transform, *const end = mat_out + nodeCount;
+			const p3mat4 *mat = cachedState->objectSpace->transform;
+			while (mat_out < end)
+				p3real4x4Product((mat_out++)->m, rootOffset_opt->m, (mat++)->m);
+		}
+		else
+			a3hierarchyTransformCopy(transform_out, cachedState->objectSpace, nodeCount);
+		return nodeCount;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_PoseCache.h
+	Content-addressed cache of evaluated hierarchy states. Characters playing
+		the same clip at the same (quantized) time with the same blend setup
+		share one evaluation; per-character root offsets are applied after.
+*/
+
+#ifndef __ANIMAL3D_POSECACHE_H
+#define __ANIMAL3D_POSECACHE_H
+
+
+#include "a3_HierarchyState.h"
+#include "a3_ClipControl.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_PoseCacheKey		a3_PoseCacheKey;
+	typedef struct a3_PoseCacheEntry	a3_PoseCacheEntry;
+	typedef struct a3_PoseCache			a3_PoseCache;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// key describing everything an evaluation depends on
+	struct a3_PoseCacheKey
+	{
+		// clip and the two key frames being interpolated
+		unsigned int clipIndex, frameIndex, nextIndex;
+
+		// quantized interpolation param between frames
+		unsigned int frameStep;
+
+		// caller-defined blend configuration and its quantized weight
+		unsigned int blendConfig, blendStep;
+	};
+
+	// single cached evaluation
+	struct a3_PoseCacheEntry
+	{
+		a3_PoseCacheKey key;
+		unsigned int hash;
+
+		// usage stamp for replacement (zero if entry is empty)
+		unsigned int stamp;
+
+		// evaluated result
+		a3_HierarchyState state[1];
+	};
+
+	// cache container: open-addressed table of entries
+	struct a3_PoseCache
+	{
+		const a3_HierarchyPoseGroup *poseGroup;
+		a3_PoseCacheEntry *entry;
+		unsigned int entryCount, entryMask;
+
+		// number of steps used to quantize params
+		unsigned int quantizeSteps;
+		float quantizeStepsInv;
+
+		// running usage counter and statistics
+		unsigned int stamp;
+		unsigned int hits, misses;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create cache with at least the requested number of entries (rounded up
+	//	to a power of two); params are quantized into the given step count
+	inline int a3poseCacheCreate(a3_PoseCache *cache_out, const a3_HierarchyPoseGroup *poseGroup, const unsigned int entryCount, const unsigned int quantizeSteps);
+
+	// release cache
+	inline int a3poseCacheRelease(a3_PoseCache *cache);
+
+	// invalidate all entries (e.g. if source poses changed)
+	inline int a3poseCacheClear(a3_PoseCache *cache);
+
+	// build key from clip controller and blend configuration
+	inline int a3poseCacheMakeKey(a3_PoseCacheKey *key_out, const a3_PoseCache *cache, const a3_ClipController *ctrl, const unsigned int blendConfig, const float blendParam);
+
+	// get the frame param represented by a key; evaluate with this value so
+	//	that everyone sharing the entry sees the same result
+	inline float a3poseCacheKeyGetFrameParam(const a3_PoseCache *cache, const a3_PoseCacheKey *key);
+
+	// get the blend param represented by a key
+	inline float a3poseCacheKeyGetBlendParam(const a3_PoseCache *cache, const a3_PoseCacheKey *key);
+
+	// find or claim entry for key
+	//	state_out is only valid until the next acquire, which may evict and 
+	//	reuse its entry (even within the same frame); copy the result out 
+	//	(e.g. with a3poseCacheApplyRootOffset) before acquiring another
+	//	return: 1 if hit; state_out holds a valid evaluation (read only)
+	//	return: 0 if miss; state_out is claimed and must be evaluated by caller
+	//	return: -1 if invalid params
+	inline int a3poseCacheAcquire(a3_PoseCache *cache, const a3_PoseCacheKey *key, a3_HierarchyState **state_out);
+
+	// copy shared object-space result to a character, applying its root
+	//	offset (pass null for no offset)
+	inline int a3poseCacheApplyRootOffset(const a3_HierarchyTransform *transform_out, const a3_HierarchyState *cachedState, const p3mat4 *rootOffset_opt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_POSECACHE_H
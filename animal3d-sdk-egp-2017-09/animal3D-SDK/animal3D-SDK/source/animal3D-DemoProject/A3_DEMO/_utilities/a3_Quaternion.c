@@ -24,9 +24,493 @@
 
 #include "a3_Quaternion.h"
 
+#include <math.h>
+
+// vector path is compiled for any x86 target; 32-bit builds without SSE 
+//	enabled check the CPU at run time before using it
+#if (defined _M_X64 || defined _M_IX86 || defined __SSE__)
+#define A3_QUATERNION_SSE
+#include <xmmintrin.h>
+#if (defined _MSC_VER)
+#include <intrin.h>
+#endif	// _MSC_VER
+#endif	// SSE
+
 
 //-----------------------------------------------------------------------------
 
+#define a3quat_deg2rad	0.0174532925199f
+#define a3quat_rad2deg	57.2957795131f
+
+
+// instruction set used by array functions (negative until first use)
+static int a3quatArrayInstructionSet = -1;
+
+
+// best instruction set supported by this CPU
+inline a3_QuatInstructionSet a3quatArrayDetect_internal()
+{
+#ifdef A3_QUATERNION_SSE
+#if (defined _M_X64 || defined __SSE__)
+	// always present
+	return a3quatInstructionSet_sse;
+#else	// !(_M_X64 || __SSE__)
+	// CPUID function 1, EDX bit 25
+	int info[4];
+	__cpuid(info, 1);
+	return ((info[3] & (1 << 25)) ? a3quatInstructionSet_sse : a3quatInstructionSet_scalar);
+#endif	// _M_X64 || __SSE__
+#else	// !A3_QUATERNION_SSE
+	return a3quatInstructionSet_scalar;
+#endif	// A3_QUATERNION_SSE
+}
+
+inline int a3quatArrayUseSSE_internal()
+{
+	return (a3quatArrayGetInstructionSet() == a3quatInstructionSet_sse);
+}
+
+// normalize single quaternion; zero length becomes identity
+inline void a3quatNormalize_internal(a3quatp q_out, const a3quatp q)
+{
+	p3real lenSq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+	if (lenSq > realZero)
+	{
+		lenSq = realOne / (p3real)sqrt(lenSq);
+		q_out[0] = q[0] * lenSq;
+		q_out[1] = q[1] * lenSq;
+		q_out[2] = q[2] * lenSq;
+		q_out[3] = q[3] * lenSq;
+	}
+	else
+	{
+		q_out[0] = q_out[1] = q_out[2] = realZero;
+		q_out[3] = realOne;
+	}
+}
+
+// corrected param for approximate SLERP given absolute dot product
+//	(cosine of half the angle between rotations)
+// the exact NLERP param that lands on the SLERP result is 
+//	sin(ta) / (sin(ta) + sin((1-t)a)), which is written as 
+//	t + t(t - 1/2)(t - 1) k, and k is fit as a polynomial in d and (t - 1/2)^2
+inline p3real a3quatSLERPFastParam_internal(const p3real d, const p3real t)
+{
+	const p3real h = t - (p3real)0.5, u = h * h;
+	const p3real k0 = (p3real)0.8588225 + d * ((p3real)-1.141863 + d * ((p3real)0.4153688 + d * ((p3real)-0.1766079 + d * (p3real)0.04446436)));
+	const p3real k1 = (p3real)0.8234425 + d * ((p3real)-2.069772 + d * ((p3real)1.834598 + d * ((p3real)-0.7637601 + d * (p3real)0.1761592)));
+	const p3real k2 = (p3real)1.159301 + d * ((p3real)-4.812052 + d * ((p3real)7.961481 + d * ((p3real)-6.25415 + d * (p3real)1.952768)));
+	return (t + t * h * (t - realOne) * (k0 + u * (k1 + u * k2)));
+}
+
+// convert to 3x4 rows
+inline void a3quatConvertToMat3x4_internal(p3real *m_out, const a3quatp q, const p3real *translate_opt)
+{
+	p3real3x3 m;
+	a3quatConvertToMat3(m, q);
+	m_out[0] = m[0][0];	m_out[1] = m[1][0];	m_out[2] = m[2][0];
+	m_out[4] = m[0][1];	m_out[5] = m[1][1];	m_out[6] = m[2][1];
+	m_out[8] = m[0][2];	m_out[9] = m[1][2];	m_out[10] = m[2][2];
+	if (translate_opt)
+	{
+		m_out[3] = translate_opt[0];
+		m_out[7] = translate_opt[1];
+		m_out[11] = translate_opt[2];
+	}
+	else
+		m_out[3] = m_out[7] = m_out[11] = realZero;
+}
+
+
+#ifdef A3_QUATERNION_SSE
+
+// vector path: each function handles groups of 4, transposing to one 
+//	component per register, and returns the number processed
+
+inline unsigned int a3quatArrayNormalize_sse_internal(a3quatp q_out, const a3quatp q, const unsigned int count)
+{
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+	__m128 x, y, z, w, lenSq, lenInv, valid;
+	unsigned int i;
+	for (i = 0; i < count - count % 4; i += 4)
+	{
+		x = _mm_loadu_ps(q + i * 4 + 0);
+		y = _mm_loadu_ps(q + i * 4 + 4);
+		z = _mm_loadu_ps(q + i * 4 + 8);
+		w = _mm_loadu_ps(q + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+		valid = _mm_cmpgt_ps(lenSq, zero);
+		// zero length: scale by zero and set w to one
+		lenInv = _mm_and_ps(valid, _mm_div_ps(one, _mm_sqrt_ps(_mm_or_ps(_mm_and_ps(valid, lenSq), _mm_andnot_ps(valid, one)))));
+		x = _mm_mul_ps(x, lenInv);
+		y = _mm_mul_ps(y, lenInv);
+		z = _mm_mul_ps(z, lenInv);
+		w = _mm_or_ps(_mm_mul_ps(w, lenInv), _mm_andnot_ps(valid, one));
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(q_out + i * 4 + 0, x);
+		_mm_storeu_ps(q_out + i * 4 + 4, y);
+		_mm_storeu_ps(q_out + i * 4 + 8, z);
+		_mm_storeu_ps(q_out + i * 4 + 12, w);
+	}
+	return i;
+}
+
+inline unsigned int a3quatArrayConcat_sse_internal(a3quatp q_out, const a3quatp qL, const a3quatp qR, const unsigned int count)
+{
+	__m128 x0, y0, z0, w0, x1, y1, z1, w1, x, y, z, w;
+	unsigned int i;
+	for (i = 0; i < count - count % 4; i += 4)
+	{
+		x0 = _mm_loadu_ps(qL + i * 4 + 0);
+		y0 = _mm_loadu_ps(qL + i * 4 + 4);
+		z0 = _mm_loadu_ps(qL + i * 4 + 8);
+		w0 = _mm_loadu_ps(qL + i * 4 + 12);
+		x1 = _mm_loadu_ps(qR + i * 4 + 0);
+		y1 = _mm_loadu_ps(qR + i * 4 + 4);
+		z1 = _mm_loadu_ps(qR + i * 4 + 8);
+		w1 = _mm_loadu_ps(qR + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(x0, y0, z0, w0);
+		_MM_TRANSPOSE4_PS(x1, y1, z1, w1);
+		x = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, x1), _mm_mul_ps(x0, w1)), _mm_mul_ps(y0, z1)), _mm_mul_ps(z0, y1));
+		y = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(w0, y1), _mm_mul_ps(x0, z1)), _mm_mul_ps(y0, w1)), _mm_mul_ps(z0, x1));
+		z = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(w0, z1), _mm_mul_ps(x0, y1)), _mm_mul_ps(y0, x1)), _mm_mul_ps(z0, w1));
+		w = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(w0, w1), _mm_mul_ps(x0, x1)), _mm_mul_ps(y0, y1)), _mm_mul_ps(z0, z1));
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(q_out + i * 4 + 0, x);
+		_mm_storeu_ps(q_out + i * 4 + 4, y);
+		_mm_storeu_ps(q_out + i * 4 + 8, z);
+		_mm_storeu_ps(q_out + i * 4 + 12, w);
+	}
+	return i;
+}
+
+// rotate 4 vectors given as one register per component
+inline void a3quatRotate_sse_internal(__m128 *vx, __m128 *vy, __m128 *vz, const __m128 x, const __m128 y, const __m128 z, const __m128 w)
+{
+	// t = r x v + wv; v' = v + 2(r x t)
+	const __m128 tx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(y, *vz), _mm_mul_ps(z, *vy)), _mm_mul_ps(w, *vx));
+	const __m128 ty = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(z, *vx), _mm_mul_ps(x, *vz)), _mm_mul_ps(w, *vy));
+	const __m128 tz = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, *vy), _mm_mul_ps(y, *vx)), _mm_mul_ps(w, *vz));
+	const __m128 two = _mm_set1_ps(2.0f);
+	*vx = _mm_add_ps(*vx, _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(y, tz), _mm_mul_ps(z, ty))));
+	*vy = _mm_add_ps(*vy, _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(z, tx), _mm_mul_ps(x, tz))));
+	*vz = _mm_add_ps(*vz, _mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(x, ty), _mm_mul_ps(y, tx))));
+}
+
+inline unsigned int a3quatArrayRotateVec4_sse_internal(p3real4p v_out, const a3quatp q, const p3real4p v, const unsigned int count)
+{
+	__m128 x, y, z, w, vx, vy, vz, vw;
+	unsigned int i;
+	for (i = 0; i < count - count % 4; i += 4)
+	{
+		x = _mm_loadu_ps(q + i * 4 + 0);
+		y = _mm_loadu_ps(q + i * 4 + 4);
+		z = _mm_loadu_ps(q + i * 4 + 8);
+		w = _mm_loadu_ps(q + i * 4 + 12);
+		vx = _mm_loadu_ps(v + i * 4 + 0);
+		vy = _mm_loadu_ps(v + i * 4 + 4);
+		vz = _mm_loadu_ps(v + i * 4 + 8);
+		vw = _mm_loadu_ps(v + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+		a3quatRotate_sse_internal(&vx, &vy, &vz, x, y, z, w);
+		_MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+		_mm_storeu_ps(v_out + i * 4 + 0, vx);
+		_mm_storeu_ps(v_out + i * 4 + 4, vy);
+		_mm_storeu_ps(v_out + i * 4 + 8, vz);
+		_mm_storeu_ps(v_out + i * 4 + 12, vw);
+	}
+	return i;
+}
+
+inline unsigned int a3quatArrayRotateVec3_sse_internal(p3real3p v_out, const a3quatp q, const p3real3p v, const unsigned int count)
+{
+	// spread groups of 3-component vectors out to 4 so they transpose
+	p3real4 tmp[4];
+	__m128 x, y, z, w, vx, vy, vz, vw;
+	unsigned int i, k;
+	for (i = 0; i < count - count % 4; i += 4)
+	{
+		for (k = 0; k < 4; ++k)
+		{
+			tmp[k][0] = v[(i + k) * 3 + 0];
+			tmp[k][1] = v[(i + k) * 3 + 1];
+			tmp[k][2] = v[(i + k) * 3 + 2];
+			tmp[k][3] = realZero;
+		}
+		x = _mm_loadu_ps(q + i * 4 + 0);
+		y = _mm_loadu_ps(q + i * 4 + 4);
+		z = _mm_loadu_ps(q + i * 4 + 8);
+		w = _mm_loadu_ps(q + i * 4 + 12);
+		vx = _mm_loadu_ps(tmp[0]);
+		vy = _mm_loadu_ps(tmp[1]);
+		vz = _mm_loadu_ps(tmp[2]);
+		vw = _mm_loadu_ps(tmp[3]);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+		a3quatRotate_sse_internal(&vx, &vy, &vz, x, y, z, w);
+		_MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+		_mm_storeu_ps(tmp[0], vx);
+		_mm_storeu_ps(tmp[1], vy);
+		_mm_storeu_ps(tmp[2], vz);
+		_mm_storeu_ps(tmp[3], vw);
+		for (k = 0; k < 4; ++k)
+		{
+			v_out[(i + k) * 3 + 0] = tmp[k][0];
+			v_out[(i + k) * 3 + 1] = tmp[k][1];
+			v_out[(i + k) * 3 + 2] = tmp[k][2];
+		}
+	}
+	return i;
+}
+
+inline unsigned int a3quatArrayUnitSLERP_sse_internal(a3quatp q_out, const a3quatp q0, const a3quatp q1, const p3real t, const unsigned int count)
+{
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+	__m128 x0, y0, z0, w0, x1, y1, z1, w1, d, flip, s0, s1, lenInv;
+	float dLane[4], w0Lane[4], w1Lane[4], angle, sinInv;
+	unsigned int i, k;
+	for (i = 0; i < count - count % 4; i += 4)
+	{
+		x0 = _mm_loadu_ps(q0 + i * 4 + 0);
+		y0 = _mm_loadu_ps(q0 + i * 4 + 4);
+		z0 = _mm_loadu_ps(q0 + i * 4 + 8);
+		w0 = _mm_loadu_ps(q0 + i * 4 + 12);
+		x1 = _mm_loadu_ps(q1 + i * 4 + 0);
+		y1 = _mm_loadu_ps(q1 + i * 4 + 4);
+		z1 = _mm_loadu_ps(q1 + i * 4 + 8);
+		w1 = _mm_loadu_ps(q1 + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(x0, y0, z0, w0);
+		_MM_TRANSPOSE4_PS(x1, y1, z1, w1);
+
+		// shortest path: negate second where dot is negative
+		d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_add_ps(_mm_mul_ps(z0, z1), _mm_mul_ps(w0, w1)));
+		flip = _mm_cmplt_ps(d, zero);
+		d = _mm_max_ps(d, _mm_sub_ps(zero, d));
+
+		// weights need inverse cosine and sine, which have no vector form
+		_mm_storeu_ps(dLane, d);
+		for (k = 0; k < 4; ++k)
+		{
+			if (dLane[k] < 0.9995f)
+			{
+				angle = (float)acos(dLane[k]);
+				sinInv = 1.0f / (float)sin(angle);
+				w0Lane[k] = (float)sin((1.0f - t) * angle) * sinInv;
+				w1Lane[k] = (float)sin(t * angle) * sinInv;
+			}
+			else
+			{
+				w0Lane[k] = 1.0f - t;
+				w1Lane[k] = t;
+			}
+		}
+		s0 = _mm_loadu_ps(w0Lane);
+		s1 = _mm_loadu_ps(w1Lane);
+		s1 = _mm_or_ps(_mm_and_ps(flip, _mm_sub_ps(zero, s1)), _mm_andnot_ps(flip, s1));
+		x0 = _mm_add_ps(_mm_mul_ps(x0, s0), _mm_mul_ps(x1, s1));
+		y0 = _mm_add_ps(_mm_mul_ps(y0, s0), _mm_mul_ps(y1, s1));
+		z0 = _mm_add_ps(_mm_mul_ps(z0, s0), _mm_mul_ps(z1, s1));
+		w0 = _mm_add_ps(_mm_mul_ps(w0, s0), _mm_mul_ps(w1, s1));
+
+		// renormalize (needed for the LERP lanes, harmless for the others)
+		lenInv = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x0), _mm_mul_ps(y0, y0)), _mm_add_ps(_mm_mul_ps(z0, z0), _mm_mul_ps(w0, w0)))));
+		x0 = _mm_mul_ps(x0, lenInv);
+		y0 = _mm_mul_ps(y0, lenInv);
+		z0 = _mm_mul_ps(z0, lenInv);
+		w0 = _mm_mul_ps(w0, lenInv);
+		_MM_TRANSPOSE4_PS(x0, y0, z0, w0);
+		_mm_storeu_ps(q_out + i * 4 + 0, x0);
+		_mm_storeu_ps(q_out + i * 4 + 4, y0);
+		_mm_storeu_ps(q_out + i * 4 + 8, z0);
+		_mm_storeu_ps(q_out + i * 4 + 12, w0);
+	}
+	return i;
+}
+
+inline unsigned int a3quatArrayUnitSLERPFast_sse_internal(a3quatp q_out, const a3quatp q0, const a3quatp q1, const p3real t, const unsigned int count)
+{
+	// param terms that do not depend on the inputs
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+	const __m128 t4 = _mm_set1_ps(t), u4 = _mm_set1_ps((t - 0.5f) * (t - 0.5f)), g4 = _mm_set1_ps(t * (t - 0.5f) * (t - 1.0f));
+	__m128 x0, y0, z0, w0, x1, y1, z1, w1, d, flip, k0, k1, k2, s0, s1, lenInv;
+	unsigned int i;
+	for (i = 0; i < count - count % 4; i += 4)
+	{
+		x0 = _mm_loadu_ps(q0 + i * 4 + 0);
+		y0 = _mm_loadu_ps(q0 + i * 4 + 4);
+		z0 = _mm_loadu_ps(q0 + i * 4 + 8);
+		w0 = _mm_loadu_ps(q0 + i * 4 + 12);
+		x1 = _mm_loadu_ps(q1 + i * 4 + 0);
+		y1 = _mm_loadu_ps(q1 + i * 4 + 4);
+		z1 = _mm_loadu_ps(q1 + i * 4 + 8);
+		w1 = _mm_loadu_ps(q1 + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(x0, y0, z0, w0);
+		_MM_TRANSPOSE4_PS(x1, y1, z1, w1);
+
+		d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_add_ps(_mm_mul_ps(z0, z1), _mm_mul_ps(w0, w1)));
+		flip = _mm_cmplt_ps(d, zero);
+		d = _mm_max_ps(d, _mm_sub_ps(zero, d));
+
+		// same polynomial as scalar
+		k0 = _mm_add_ps(_mm_set1_ps(-0.1766079f), _mm_mul_ps(d, _mm_set1_ps(0.04446436f)));
+		k0 = _mm_add_ps(_mm_set1_ps(0.4153688f), _mm_mul_ps(d, k0));
+		k0 = _mm_add_ps(_mm_set1_ps(-1.141863f), _mm_mul_ps(d, k0));
+		k0 = _mm_add_ps(_mm_set1_ps(0.8588225f), _mm_mul_ps(d, k0));
+		k1 = _mm_add_ps(_mm_set1_ps(-0.7637601f), _mm_mul_ps(d, _mm_set1_ps(0.1761592f)));
+		k1 = _mm_add_ps(_mm_set1_ps(1.834598f), _mm_mul_ps(d, k1));
+		k1 = _mm_add_ps(_mm_set1_ps(-2.069772f), _mm_mul_ps(d, k1));
+		k1 = _mm_add_ps(_mm_set1_ps(0.8234425f), _mm_mul_ps(d, k1));
+		k2 = _mm_add_ps(_mm_set1_ps(-6.25415f), _mm_mul_ps(d, _mm_set1_ps(1.952768f)));
+		k2 = _mm_add_ps(_mm_set1_ps(7.961481f), _mm_mul_ps(d, k2));
+		k2 = _mm_add_ps(_mm_set1_ps(-4.812052f), _mm_mul_ps(d, k2));
+		k2 = _mm_add_ps(_mm_set1_ps(1.159301f), _mm_mul_ps(d, k2));
+		s1 = _mm_add_ps(t4, _mm_mul_ps(g4, _mm_add_ps(k0, _mm_mul_ps(u4, _mm_add_ps(k1, _mm_mul_ps(u4, k2))))));
+		s0 = _mm_sub_ps(one, s1);
+		s1 = _mm_or_ps(_mm_and_ps(flip, _mm_sub_ps(zero, s1)), _mm_andnot_ps(flip, s1));
+
+		x0 = _mm_add_ps(_mm_mul_ps(x0, s0), _mm_mul_ps(x1, s1));
+		y0 = _mm_add_ps(_mm_mul_ps(y0, s0), _mm_mul_ps(y1, s1));
+		z0 = _mm_add_ps(_mm_mul_ps(z0, s0), _mm_mul_ps(z1, s1));
+		w0 = _mm_add_ps(_mm_mul_ps(w0, s0), _mm_mul_ps(w1, s1));
+		lenInv = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x0), _mm_mul_ps(y0, y0)), _mm_add_ps(_mm_mul_ps(z0, z0), _mm_mul_ps(w0, w0)))));
+		x0 = _mm_mul_ps(x0, lenInv);
+		y0 = _mm_mul_ps(y0, lenInv);
+		z0 = _mm_mul_ps(z0, lenInv);
+		w0 = _mm_mul_ps(w0, lenInv);
+		_MM_TRANSPOSE4_PS(x0, y0, z0, w0);
+		_mm_storeu_ps(q_out + i * 4 + 0, x0);
+		_mm_storeu_ps(q_out + i * 4 + 4, y0);
+		_mm_storeu_ps(q_out + i * 4 + 8, z0);
+		_mm_storeu_ps(q_out + i * 4 + 12, w0);
+	}
+	return i;
+}
+
+// rotation matrix entries for 4 quaternions, one register per entry: 
+//	m[column * 3 + row]
+inline void a3quatConvert_sse_internal(__m128 *m, const a3quatp q)
+{
+	__m128 x = _mm_loadu_ps(q + 0), y = _mm_loadu_ps(q + 4), z = _mm_loadu_ps(q + 8), w = _mm_loadu_ps(q + 12);
+	__m128 x2, y2, z2, xx, yy, zz, xy, xz, yz, wx, wy, wz;
+	const __m128 one = _mm_set1_ps(1.0f);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	x2 = _mm_add_ps(x, x);
+	y2 = _mm_add_ps(y, y);
+	z2 = _mm_add_ps(z, z);
+	xx = _mm_mul_ps(x, x2);
+	yy = _mm_mul_ps(y, y2);
+	zz = _mm_mul_ps(z, z2);
+	xy = _mm_mul_ps(x, y2);
+	xz = _mm_mul_ps(x, z2);
+	yz = _mm_mul_ps(y, z2);
+	wx = _mm_mul_ps(w, x2);
+	wy = _mm_mul_ps(w, y2);
+	wz = _mm_mul_ps(w, z2);
+	m[0] = _mm_sub_ps(_mm_sub_ps(one, yy), zz);
+	m[1] = _mm_add_ps(xy, wz);
+	m[2] = _mm_sub_ps(xz, wy);
+	m[3] = _mm_sub_ps(xy, wz);
+	m[4] = _mm_sub_ps(_mm_sub_ps(one, xx), zz);
+	m[5] = _mm_add_ps(yz, wx);
+	m[6] = _mm_add_ps(xz, wy);
+	m[7] = _mm_sub_ps(yz, wx);
+	m[8] = _mm_sub_ps(_mm_sub_ps(one, xx), yy);
+}
+
+inline unsigned int a3quatArrayConvertToMat4_sse_internal(p3mat4 *m_out, const a3quatp q, const p3real4p translate_opt, const unsigned int count)
+{
+	__m128 m[9], c0, c1, c2, c3;
+	unsigned int i, c, k;
+	for (i = 0; i < count - count % 4; i += 4, m_out += 4)
+	{
+		a3quatConvert_sse_internal(m, q + i * 4);
+
+		// transposing a column's entries gives that column for each matrix
+		for (c = 0; c < 3; ++c)
+		{
+			c0 = m[c * 3 + 0];
+			c1 = m[c * 3 + 1];
+			c2 = m[c * 3 + 2];
+			c3 = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(m_out[0].m[c], c0);
+			_mm_storeu_ps(m_out[1].m[c], c1);
+			_mm_storeu_ps(m_out[2].m[c], c2);
+			_mm_storeu_ps(m_out[3].m[c], c3);
+		}
+		for (k = 0; k < 4; ++k)
+		{
+			if (translate_opt)
+			{
+				m_out[k].m[3][0] = translate_opt[(i + k) * 4 + 0];
+				m_out[k].m[3][1] = translate_opt[(i + k) * 4 + 1];
+				m_out[k].m[3][2] = translate_opt[(i + k) * 4 + 2];
+			}
+			else
+				m_out[k].m[3][0] = m_out[k].m[3][1] = m_out[k].m[3][2] = realZero;
+			m_out[k].m[3][3] = realOne;
+		}
+	}
+	return i;
+}
+
+inline unsigned int a3quatArrayConvertToMat3x4_sse_internal(p3real *m_out, const a3quatp q, const p3real4p translate_opt, const unsigned int count)
+{
+	__m128 m[9], t[4], r0, r1, r2, r3;
+	unsigned int i, r;
+	for (i = 0; i < count - count % 4; i += 4, m_out += 48)
+	{
+		a3quatConvert_sse_internal(m, q + i * 4);
+		if (translate_opt)
+		{
+			t[0] = _mm_loadu_ps(translate_opt + i * 4 + 0);
+			t[1] = _mm_loadu_ps(translate_opt + i * 4 + 4);
+			t[2] = _mm_loadu_ps(translate_opt + i * 4 + 8);
+			t[3] = _mm_loadu_ps(translate_opt + i * 4 + 12);
+			_MM_TRANSPOSE4_PS(t[0], t[1], t[2], t[3]);
+		}
+		else
+			t[0] = t[1] = t[2] = _mm_setzero_ps();
+
+		// transposing a row's entries gives that row for each matrix
+		for (r = 0; r < 3; ++r)
+		{
+			r0 = m[0 + r];
+			r1 = m[3 + r];
+			r2 = m[6 + r];
+			r3 = t[r];
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			_mm_storeu_ps(m_out + 0 + r * 4, r0);
+			_mm_storeu_ps(m_out + 12 + r * 4, r1);
+			_mm_storeu_ps(m_out + 24 + r * 4, r2);
+			_mm_storeu_ps(m_out + 36 + r * 4, r3);
+		}
+	}
+	return i;
+}
+
+inline unsigned int a3quatArrayConvertToMat3_sse_internal(p3real3x3 *m_out, const a3quatp q, const unsigned int count)
+{
+	__m128 m[9];
+	float entry[9][4];
+	unsigned int i, e, k;
+	for (i = 0; i < count - count % 4; i += 4, m_out += 4)
+	{
+		a3quatConvert_sse_internal(m, q + i * 4);
+		for (e = 0; e < 9; ++e)
+			_mm_storeu_ps(entry[e], m[e]);
+		for (k = 0; k < 4; ++k)
+			for (e = 0; e < 9; ++e)
+				m_out[k][e / 3][e % 3] = entry[e][k];
+	}
+	return i;
+}
+
+#endif	// A3_QUATERNION_SSE
+
+
 // create identity quaternion
 extern inline int a3quatCreateIdentity(a3quatp q_out)
 {
@@ -48,9 +532,14 @@ extern inline int a3quatCreateAxisAngle(a3quatp q_out, const p3real3p axis_unit,
 {
 	if (q_out && axis_unit)
 	{
-		// ****TO-DO: implement
 		// v = sin(angle / 2) * n
 		// w = cos(angle / 2)
+		const p3real halfAngle = angle_degrees * (realHalf * a3quat_deg2rad);
+		const p3real s = (p3real)sin(halfAngle);
+		q_out[0] = axis_unit[0] * s;
+		q_out[1] = axis_unit[1] * s;
+		q_out[2] = axis_unit[2] * s;
+		q_out[3] = (p3real)cos(halfAngle);
 
 		// done
 		return 1;
@@ -62,13 +551,61 @@ extern inline int a3quatCreateDelta(a3quatp q_out, const p3real3p v0_unit, const
 {
 	if (q_out && v0_unit && v1_unit)
 	{
-		// ****TO-DO: implement
 		// SUPER PRO TIP for fast quaternion creation: 
 		// Here are some fun facts about unit vectors: 
 		//	-> a  dot  b = cos(angle)
 		//	-> a cross b = sin(angle) * n
 		// Since a quaternion uses half angle, we can solve by using 
 		//	the unit halfway vector as 'b'!!!
+		p3real h[3] = { v0_unit[0] + v1_unit[0], v0_unit[1] + v1_unit[1], v0_unit[2] + v1_unit[2] };
+		p3real lenSq = h[0] * h[0] + h[1] * h[1] + h[2] * h[2];
+		if (lenSq > (p3real)1.0e-12)
+		{
+			lenSq = realOne / (p3real)sqrt(lenSq);
+			h[0] *= lenSq;
+			h[1] *= lenSq;
+			h[2] *= lenSq;
+			q_out[0] = v0_unit[1] * h[2] - v0_unit[2] * h[1];
+			q_out[1] = v0_unit[2] * h[0] - v0_unit[0] * h[2];
+			q_out[2] = v0_unit[0] * h[1] - v0_unit[1] * h[0];
+			q_out[3] = v0_unit[0] * h[0] + v0_unit[1] * h[1] + v0_unit[2] * h[2];
+		}
+		else
+		{
+			// opposite vectors: half turn about any perpendicular axis
+			if (v0_unit[0] * v0_unit[0] < realHalf)
+				p3real3Set(h, realZero, v0_unit[2], -v0_unit[1]);
+			else
+				p3real3Set(h, -v0_unit[2], realZero, v0_unit[0]);
+			p3real3Normalize(h);
+			q_out[0] = h[0];
+			q_out[1] = h[1];
+			q_out[2] = h[2];
+			q_out[3] = realZero;
+		}
+
+		// done
+		return 1;
+	}
+	return 0;
+}
+
+// create quaternion from Euler angles
+extern inline int a3quatCreateEulerZYX(a3quatp q_out, const p3real x_degrees, const p3real y_degrees, const p3real z_degrees)
+{
+	if (q_out)
+	{
+		// q = qz * qy * qx, expanded using half angles
+		const p3real hx = x_degrees * ((p3real)0.5 * a3quat_deg2rad);
+		const p3real hy = y_degrees * ((p3real)0.5 * a3quat_deg2rad);
+		const p3real hz = z_degrees * ((p3real)0.5 * a3quat_deg2rad);
+		const p3real cx = (p3real)cos(hx), sx = (p3real)sin(hx);
+		const p3real cy = (p3real)cos(hy), sy = (p3real)sin(hy);
+		const p3real cz = (p3real)cos(hz), sz = (p3real)sin(hz);
+		q_out[0] = cz * cy * sx - sz * sy * cx;
+		q_out[1] = cz * sy * cx + sz * cy * sx;
+		q_out[2] = sz * cy * cx - cz * sy * sx;
+		q_out[3] = cz * cy * cx + sz * sy * sx;
 
 		// done
 		return 1;
@@ -81,12 +618,25 @@ extern inline int a3quatGetAxisAngle(p3real3p axis_out, p3real *angle_degrees_ou
 {
 	if (axis_out && angle_degrees_out && q)
 	{
-		// ****TO-DO: implement
 		// if w is between +/- 1, 
 		//	-> extract axis by normalizing vector part
 		//	-> extract angle by taking inverse cosine of W and double it
 		// else
 		//	-> return all zeros
+		const p3real lenSq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2];
+		if (q[3] > -realOne && q[3] < realOne && lenSq > realZero)
+		{
+			const p3real lenInv = realOne / (p3real)sqrt(lenSq);
+			axis_out[0] = q[0] * lenInv;
+			axis_out[1] = q[1] * lenInv;
+			axis_out[2] = q[2] * lenInv;
+			*angle_degrees_out = (p3real)acos(q[3]) * (realTwo * a3quat_rad2deg);
+		}
+		else
+		{
+			axis_out[0] = axis_out[1] = axis_out[2] = realZero;
+			*angle_degrees_out = realZero;
+		}
 
 		// done
 		return 1;
@@ -99,8 +649,11 @@ extern inline int a3quatConjugate(a3quatp qConj_out, const a3quatp q)
 {
 	if (qConj_out && q)
 	{
-		// ****TO-DO: implement
 		// vector part is negative
+		qConj_out[0] = -q[0];
+		qConj_out[1] = -q[1];
+		qConj_out[2] = -q[2];
+		qConj_out[3] = q[3];
 
 		// done
 		return 1;
@@ -113,8 +666,13 @@ extern inline int a3quatInverse(a3quatp qInv_out, const a3quatp q)
 {
 	if (qInv_out && q)
 	{
-		// ****TO-DO: implement
 		// conjugate divided by squared magnitude
+		const p3real lenSq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+		const p3real lenSqInv = lenSq > realZero ? realOne / lenSq : realZero;
+		qInv_out[0] = -q[0] * lenSqInv;
+		qInv_out[1] = -q[1] * lenSqInv;
+		qInv_out[2] = -q[2] * lenSqInv;
+		qInv_out[3] = q[3] * lenSqInv;
 
 		// done
 		return 1;
@@ -127,12 +685,18 @@ extern inline int a3quatConcat(a3quatp qConcat_out, const a3quatp qL, const a3qu
 {
 	if (qConcat_out && qL && qR)
 	{
-		// ****TO-DO: implement
 		// use full formula, it's faster: 
 		//	x = w0x1 + x0w1 + y0z1 - z0y1
 		//	y = w0y1 - x0z1 + y0w1 + z0x1
 		//	z = w0z1 + x0y1 - y0x1 + z0w1
 		//	w = w0w1 - x0x1 - y0y1 - z0z1
+		// (copy inputs first in case output is also an input)
+		const p3real x0 = qL[0], y0 = qL[1], z0 = qL[2], w0 = qL[3];
+		const p3real x1 = qR[0], y1 = qR[1], z1 = qR[2], w1 = qR[3];
+		qConcat_out[0] = w0 * x1 + x0 * w1 + y0 * z1 - z0 * y1;
+		qConcat_out[1] = w0 * y1 - x0 * z1 + y0 * w1 + z0 * x1;
+		qConcat_out[2] = w0 * z1 + x0 * y1 - y0 * x1 + z0 * w1;
+		qConcat_out[3] = w0 * w1 - x0 * x1 - y0 * y1 - z0 * z1;
 
 		// done
 		return 1;
@@ -145,9 +709,16 @@ extern inline int a3quatRotateVec3(p3real3p vRot_out, const a3quatp q, const p3r
 {
 	if (vRot_out && q && v)
 	{
-		// ****TO-DO: implement
 		// expand shortened formula: 
 		//	v' = v + (r + r)x(r x v + wv)
+		const p3real x = q[0], y = q[1], z = q[2], w = q[3];
+		const p3real vx = v[0], vy = v[1], vz = v[2];
+		const p3real tx = y * vz - z * vy + w * vx;
+		const p3real ty = z * vx - x * vz + w * vy;
+		const p3real tz = x * vy - y * vx + w * vz;
+		vRot_out[0] = vx + realTwo * (y * tz - z * ty);
+		vRot_out[1] = vy + realTwo * (z * tx - x * tz);
+		vRot_out[2] = vz + realTwo * (x * ty - y * tx);
 
 		// done
 		return 1;
@@ -160,8 +731,10 @@ extern inline int a3quatRotateVec4(p3real4p vRot_out, const a3quatp q, const p3r
 {
 	if (vRot_out && q && v)
 	{
-		// ****TO-DO: implement
 		// same as above but set w component
+		const p3real w = v[3];
+		a3quatRotateVec3(vRot_out, q, v);
+		vRot_out[3] = w;
 
 		// done
 		return 1;
@@ -174,9 +747,43 @@ extern inline int a3quatUnitSLERP(a3quatp qSlerp_out, const a3quatp q0_unit, con
 {
 	if (qSlerp_out && q0_unit && q1_unit)
 	{
-		// ****TO-DO: implement
 		// PRO TIP: if "angle" is negative, flip second quaternion
 		// PRO TIP: raw SLERP formula is not enough; what if inputs are parallel?
+		p3real d = q0_unit[0] * q1_unit[0] + q0_unit[1] * q1_unit[1] + q0_unit[2] * q1_unit[2] + q0_unit[3] * q1_unit[3];
+		p3real s = realOne, w0, w1, angle;
+		if (d < realZero)
+		{
+			d = -d;
+			s = -realOne;
+		}
+		if (d < (p3real)0.9995)
+		{
+			// sin((1-t)a)/sin(a), sin(ta)/sin(a)
+			angle = (p3real)acos(d);
+			w1 = realOne / (p3real)sin(angle);
+			w0 = (p3real)sin((realOne - t) * angle) * w1;
+			w1 *= (p3real)sin(t * angle) * s;
+			qSlerp_out[0] = q0_unit[0] * w0 + q1_unit[0] * w1;
+			qSlerp_out[1] = q0_unit[1] * w0 + q1_unit[1] * w1;
+			qSlerp_out[2] = q0_unit[2] * w0 + q1_unit[2] * w1;
+			qSlerp_out[3] = q0_unit[3] * w0 + q1_unit[3] * w1;
+		}
+		else
+		{
+			// nearly parallel: LERP and normalize
+			w0 = realOne - t;
+			w1 = t * s;
+			qSlerp_out[0] = q0_unit[0] * w0 + q1_unit[0] * w1;
+			qSlerp_out[1] = q0_unit[1] * w0 + q1_unit[1] * w1;
+			qSlerp_out[2] = q0_unit[2] * w0 + q1_unit[2] * w1;
+			qSlerp_out[3] = q0_unit[3] * w0 + q1_unit[3] * w1;
+			d = qSlerp_out[0] * qSlerp_out[0] + qSlerp_out[1] * qSlerp_out[1] + qSlerp_out[2] * qSlerp_out[2] + qSlerp_out[3] * qSlerp_out[3];
+			d = realOne / (p3real)sqrt(d);
+			qSlerp_out[0] *= d;
+			qSlerp_out[1] *= d;
+			qSlerp_out[2] *= d;
+			qSlerp_out[3] *= d;
+		}
 
 		// done
 		return 1;
@@ -184,16 +791,97 @@ extern inline int a3quatUnitSLERP(a3quatp qSlerp_out, const a3quatp q0_unit, con
 	return 0;
 }
 
+// approximate SLERP
+extern inline int a3quatUnitSLERPFast(a3quatp qSlerp_out, const a3quatp q0_unit, const a3quatp q1_unit, const p3real t)
+{
+	if (qSlerp_out && q0_unit && q1_unit)
+	{
+		// same shortest path rule as SLERP, then LERP with corrected param 
+		//	and normalize
+		const p3real d = q0_unit[0] * q1_unit[0] + q0_unit[1] * q1_unit[1] + q0_unit[2] * q1_unit[2] + q0_unit[3] * q1_unit[3];
+		const p3real s = d < realZero ? -realOne : realOne;
+		const p3real w1 = a3quatSLERPFastParam_internal(d * s, t), w0 = realOne - w1;
+		p3real lenInv;
+		qSlerp_out[0] = q0_unit[0] * w0 + q1_unit[0] * w1 * s;
+		qSlerp_out[1] = q0_unit[1] * w0 + q1_unit[1] * w1 * s;
+		qSlerp_out[2] = q0_unit[2] * w0 + q1_unit[2] * w1 * s;
+		qSlerp_out[3] = q0_unit[3] * w0 + q1_unit[3] * w1 * s;
+		lenInv = realOne / (p3real)sqrt(qSlerp_out[0] * qSlerp_out[0] + qSlerp_out[1] * qSlerp_out[1] + qSlerp_out[2] * qSlerp_out[2] + qSlerp_out[3] * qSlerp_out[3]);
+		qSlerp_out[0] *= lenInv;
+		qSlerp_out[1] *= lenInv;
+		qSlerp_out[2] *= lenInv;
+		qSlerp_out[3] *= lenInv;
+
+		// done
+		return 1;
+	}
+	return 0;
+}
+
+// measure approximate SLERP error
+extern inline int a3quatUnitSLERPFastError(p3real *maxError_out, p3real *meanError_out, const unsigned int angleSteps, const unsigned int paramSteps)
+{
+	if (maxError_out && meanError_out && angleSteps && paramSteps)
+	{
+		// rotate about a tilted axis so all components are exercised
+		const p3real axis[3] = { (p3real)0.48, (p3real)0.6, (p3real)0.64 };
+		a3quat q0, q1, qExact, qFast;
+		p3real angle, t, s, err, errMax = realZero;
+		double errSum = 0.0, chordSq;
+		unsigned int i, j, k;
+
+		a3quatCreateAxisAngle(q0, axis, (p3real)-23.0);
+		for (i = 1; i <= angleSteps; ++i)
+		{
+			angle = realOneEighty * (p3real)i / (p3real)angleSteps;
+			a3quatCreateAxisAngle(q1, axis, angle);
+			a3quatConcat(q1, q1, q0);
+			for (j = 0; j <= paramSteps; ++j)
+			{
+				t = (p3real)j / (p3real)paramSteps;
+				a3quatUnitSLERP(qExact, q0, q1, t);
+				a3quatUnitSLERPFast(qFast, q0, q1, t);
+
+				// angle of rotation between results, from chord length 
+				//	(inverse cosine of the dot product is too coarse near 1)
+				s = qExact[0] * qFast[0] + qExact[1] * qFast[1] + qExact[2] * qFast[2] + qExact[3] * qFast[3];
+				s = s < realZero ? -realOne : realOne;
+				for (k = 0, chordSq = 0.0; k < 4; ++k)
+					chordSq += (double)(qExact[k] - qFast[k] * s) * (double)(qExact[k] - qFast[k] * s);
+				err = (p3real)(4.0 * asin(0.5 * sqrt(chordSq)));
+				errMax = err > errMax ? err : errMax;
+				errSum += err;
+			}
+		}
+		*maxError_out = errMax;
+		*meanError_out = (p3real)(errSum / (double)(angleSteps * (paramSteps + 1)));
+		return (angleSteps * (paramSteps + 1));
+	}
+	return 0;
+}
+
 // convert to mat3
 extern inline int a3quatConvertToMat3(p3real3x3p m_out, const a3quatp q)
 {
 	if (m_out && q)
 	{
-		// ****TO-DO: implement
 		// start by writing shortcuts, then apply conversion formula
 		// NOTE: matrices are COLUMN-MAJOR; index like this: 
 		//	m_out[column][row]
 		//	e.g. upper-right would be m_out[2][0]
+		const p3real x2 = q[0] + q[0], y2 = q[1] + q[1], z2 = q[2] + q[2];
+		const p3real xx = q[0] * x2, yy = q[1] * y2, zz = q[2] * z2;
+		const p3real xy = q[0] * y2, xz = q[0] * z2, yz = q[1] * z2;
+		const p3real wx = q[3] * x2, wy = q[3] * y2, wz = q[3] * z2;
+		m_out[0][0] = realOne - yy - zz;
+		m_out[0][1] = xy + wz;
+		m_out[0][2] = xz - wy;
+		m_out[1][0] = xy - wz;
+		m_out[1][1] = realOne - xx - zz;
+		m_out[1][2] = yz + wx;
+		m_out[2][0] = xz + wy;
+		m_out[2][1] = yz - wx;
+		m_out[2][2] = realOne - xx - yy;
 
 		// done
 		return 1;
@@ -206,10 +894,34 @@ extern inline int a3quatConvertToMat4(p3real4x4p m_out, const a3quatp q, const p
 {
 	if (m_out && q)
 	{
-		// ****TO-DO: implement
 		// same as above but copy translate into fourth column
 		//	and setting bottom row to (0, 0, 0, 1)
 		// NOTE: matrices are COLUMN-MAJOR
+		const p3real x2 = q[0] + q[0], y2 = q[1] + q[1], z2 = q[2] + q[2];
+		const p3real xx = q[0] * x2, yy = q[1] * y2, zz = q[2] * z2;
+		const p3real xy = q[0] * y2, xz = q[0] * z2, yz = q[1] * z2;
+		const p3real wx = q[3] * x2, wy = q[3] * y2, wz = q[3] * z2;
+		m_out[0][0] = realOne - yy - zz;
+		m_out[0][1] = xy + wz;
+		m_out[0][2] = xz - wy;
+		m_out[0][3] = realZero;
+		m_out[1][0] = xy - wz;
+		m_out[1][1] = realOne - xx - zz;
+		m_out[1][2] = yz + wx;
+		m_out[1][3] = realZero;
+		m_out[2][0] = xz + wy;
+		m_out[2][1] = yz - wx;
+		m_out[2][2] = realOne - xx - yy;
+		m_out[2][3] = realZero;
+		if (translate)
+		{
+			m_out[3][0] = translate[0];
+			m_out[3][1] = translate[1];
+			m_out[3][2] = translate[2];
+		}
+		else
+			m_out[3][0] = m_out[3][1] = m_out[3][2] = realZero;
+		m_out[3][3] = realOne;
 
 		// done
 		return 1;
@@ -218,4 +930,176 @@ extern inline int a3quatConvertToMat4(p3real4x4p m_out, const a3quatp q, const p
 }
 
 
+//-----------------------------------------------------------------------------
+
+// get instruction set
+extern inline a3_QuatInstructionSet a3quatArrayGetInstructionSet()
+{
+	if (a3quatArrayInstructionSet < 0)
+		a3quatArrayInstructionSet = a3quatArrayDetect_internal();
+	return (a3_QuatInstructionSet)a3quatArrayInstructionSet;
+}
+
+// force instruction set
+extern inline a3_QuatInstructionSet a3quatArraySetInstructionSet(const a3_QuatInstructionSet instructionSet)
+{
+	const a3_QuatInstructionSet supported = a3quatArrayDetect_internal();
+	a3quatArrayInstructionSet = instructionSet < supported ? instructionSet : supported;
+	return (a3_QuatInstructionSet)a3quatArrayInstructionSet;
+}
+
+// normalize list
+extern inline int a3quatArrayNormalize(a3quatp q_out, const a3quatp q, const unsigned int count)
+{
+	if (q_out && q)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayNormalize_sse_internal(q_out, q, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatNormalize_internal(q_out + i * 4, q + i * 4);
+		return count;
+	}
+	return -1;
+}
+
+// concatenate pairs
+extern inline int a3quatArrayConcat(a3quatp q_out, const a3quatp qL, const a3quatp qR, const unsigned int count)
+{
+	if (q_out && qL && qR)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayConcat_sse_internal(q_out, qL, qR, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatConcat(q_out + i * 4, qL + i * 4, qR + i * 4);
+		return count;
+	}
+	return -1;
+}
+
+// rotate list of 3D vectors
+extern inline int a3quatArrayRotateVec3(p3real3p v_out, const a3quatp q, const p3real3p v, const unsigned int count)
+{
+	if (v_out && q && v)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayRotateVec3_sse_internal(v_out, q, v, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatRotateVec3(v_out + i * 3, q + i * 4, v + i * 3);
+		return count;
+	}
+	return -1;
+}
+
+// rotate list of 4D vectors
+extern inline int a3quatArrayRotateVec4(p3real4p v_out, const a3quatp q, const p3real4p v, const unsigned int count)
+{
+	if (v_out && q && v)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayRotateVec4_sse_internal(v_out, q, v, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatRotateVec4(v_out + i * 4, q + i * 4, v + i * 4);
+		return count;
+	}
+	return -1;
+}
+
+// SLERP pairs
+extern inline int a3quatArrayUnitSLERP(a3quatp q_out, const a3quatp q0_unit, const a3quatp q1_unit, const p3real t, const unsigned int count)
+{
+	if (q_out && q0_unit && q1_unit)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayUnitSLERP_sse_internal(q_out, q0_unit, q1_unit, t, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatUnitSLERP(q_out + i * 4, q0_unit + i * 4, q1_unit + i * 4, t);
+		return count;
+	}
+	return -1;
+}
+
+// approximate SLERP pairs
+extern inline int a3quatArrayUnitSLERPFast(a3quatp q_out, const a3quatp q0_unit, const a3quatp q1_unit, const p3real t, const unsigned int count)
+{
+	if (q_out && q0_unit && q1_unit)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayUnitSLERPFast_sse_internal(q_out, q0_unit, q1_unit, t, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatUnitSLERPFast(q_out + i * 4, q0_unit + i * 4, q1_unit + i * 4, t);
+		return count;
+	}
+	return -1;
+}
+
+// convert list to mat3
+extern inline int a3quatArrayConvertToMat3(p3real3x3 *m_out, const a3quatp q, const unsigned int count)
+{
+	if (m_out && q)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayConvertToMat3_sse_internal(m_out, q, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatConvertToMat3(m_out[i], q + i * 4);
+		return count;
+	}
+	return -1;
+}
+
+// convert list to 3x4
+extern inline int a3quatArrayConvertToMat3x4(p3real *m_out, const a3quatp q, const p3real4p translate_opt, const unsigned int count)
+{
+	if (m_out && q)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayConvertToMat3x4_sse_internal(m_out, q, translate_opt, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatConvertToMat3x4_internal(m_out + i * 12, q + i * 4, translate_opt ? translate_opt + i * 4 : 0);
+		return count;
+	}
+	return -1;
+}
+
+// convert list to mat4
+extern inline int a3quatArrayConvertToMat4(p3mat4 *m_out, const a3quatp q, const p3real4p translate_opt, const unsigned int count)
+{
+	if (m_out && q)
+	{
+		unsigned int i = 0;
+#ifdef A3_QUATERNION_SSE
+		if (a3quatArrayUseSSE_internal())
+			i = a3quatArrayConvertToMat4_sse_internal(m_out, q, translate_opt, count);
+#endif	// A3_QUATERNION_SSE
+		for (; i < count; ++i)
+			a3quatConvertToMat4(m_out[i].m, q + i * 4, translate_opt ? translate_opt + i * 4 : 0);
+		return count;
+	}
+	return -1;
+}
+
+
 //-----------------------------------------------------------------------------
@@ -35,6 +35,8 @@
 #ifdef __cplusplus
 extern "C"
 {
+#else	// !__cplusplus
+	typedef enum a3_QuatInstructionSet	a3_QuatInstructionSet;
 #endif	// __cplusplus
 
 
@@ -45,6 +47,14 @@ extern "C"
 	typedef p3real4p	a3quatp;
 
 
+	// instruction sets available to array functions
+	enum a3_QuatInstructionSet
+	{
+		a3quatInstructionSet_scalar,
+		a3quatInstructionSet_sse,
+	};
+
+
 //-----------------------------------------------------------------------------
 
 	// create identity quaternion
@@ -56,6 +66,10 @@ extern "C"
 	// create quaternion from two normalized end vectors
 	inline int a3quatCreateDelta(a3quatp q_out, const p3real3p v0, const p3real3p v1);
 
+	// create quaternion from Euler angles in degrees, matching the matrix 
+	//	built by p3real4x4SetRotateZYX (X applied first, then Y, then Z)
+	inline int a3quatCreateEulerZYX(a3quatp q_out, const p3real x_degrees, const p3real y_degrees, const p3real z_degrees);
+
 	// extract axis-angle from quaternion
 	inline int a3quatGetAxisAngle(p3real3p axis_out, p3real *angle_degrees_out, const a3quatp q);
 
@@ -77,6 +91,15 @@ extern "C"
 	// SLERP between two unit quaternions
 	inline int a3quatUnitSLERP(a3quatp qSlerp_out, const a3quatp q0_unit, const a3quatp q1_unit, const p3real t);
 
+	// approximate SLERP: NLERP with a polynomial correction to the param; 
+	//	no inverse cosine or sine, rotation error stays below 1e-4 radians
+	inline int a3quatUnitSLERPFast(a3quatp qSlerp_out, const a3quatp q0_unit, const a3quatp q1_unit, const p3real t);
+
+	// measure approximate SLERP against exact over a grid of angles between 
+	//	inputs (0 to 180 degrees) and params; errors are rotation angles in 
+	//	radians; returns number of samples
+	inline int a3quatUnitSLERPFastError(p3real *maxError_out, p3real *meanError_out, const unsigned int angleSteps, const unsigned int paramSteps);
+
 	// convert to mat3
 	inline int a3quatConvertToMat3(p3real3x3p m_out, const a3quatp q);
 
@@ -84,6 +107,51 @@ extern "C"
 	inline int a3quatConvertToMat4(p3real4x4p m_out, const a3quatp q, const p3real3p translate);
 
 
+//-----------------------------------------------------------------------------
+
+	// array functions: process a contiguous list of quaternions (4 reals 
+	//	each) per call; the best instruction set supported by the CPU is 
+	//	chosen on first use, groups of 4 go through the vector path and the 
+	//	remainder through the single functions above
+	//	return: count if success, -1 if invalid params
+
+	// get instruction set used by array functions
+	inline a3_QuatInstructionSet a3quatArrayGetInstructionSet();
+
+	// force instruction set (e.g. scalar for comparison); clamped to what 
+	//	the CPU supports; returns the set now in use
+	inline a3_QuatInstructionSet a3quatArraySetInstructionSet(const a3_QuatInstructionSet instructionSet);
+
+	// normalize list (zero-length quaternions become identity)
+	inline int a3quatArrayNormalize(a3quatp q_out, const a3quatp q, const unsigned int count);
+
+	// concatenate pairs: q_out[i] = qL[i] * qR[i]
+	inline int a3quatArrayConcat(a3quatp q_out, const a3quatp qL, const a3quatp qR, const unsigned int count);
+
+	// rotate list of 3D vectors (3 reals each)
+	inline int a3quatArrayRotateVec3(p3real3p v_out, const a3quatp q, const p3real3p v, const unsigned int count);
+
+	// rotate list of 4D vectors/points (4 reals each, w is kept)
+	inline int a3quatArrayRotateVec4(p3real4p v_out, const a3quatp q, const p3real4p v, const unsigned int count);
+
+	// SLERP pairs of unit quaternions with shared param
+	inline int a3quatArrayUnitSLERP(a3quatp q_out, const a3quatp q0_unit, const a3quatp q1_unit, const p3real t, const unsigned int count);
+
+	// approximate SLERP pairs of unit quaternions with shared param
+	inline int a3quatArrayUnitSLERPFast(a3quatp q_out, const a3quatp q0_unit, const a3quatp q1_unit, const p3real t, const unsigned int count);
+
+	// convert list to mat3
+	inline int a3quatArrayConvertToMat3(p3real3x3 *m_out, const a3quatp q, const unsigned int count);
+
+	// convert list to 3x4: three rows of four reals each, rotation rows with 
+	//	translation in the last element (e.g. for packed uniform buffers); 
+	//	translations are 4 reals each, pass null for none
+	inline int a3quatArrayConvertToMat3x4(p3real *m_out, const a3quatp q, const p3real4p translate_opt, const unsigned int count);
+
+	// convert list to mat4; translations are 4 reals each, pass null for none
+	inline int a3quatArrayConvertToMat4(p3mat4 *m_out, const a3quatp q, const p3real4p translate_opt, const unsigned int count);
+
+
 //-----------------------------------------------------------------------------
 
 
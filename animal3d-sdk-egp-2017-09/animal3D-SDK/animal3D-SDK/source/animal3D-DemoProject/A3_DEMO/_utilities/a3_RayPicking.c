@@ -24,6 +24,410 @@
 
 #include "a3_RayPicking.h"
 
+#include <stdlib.h>
+#include <math.h>
+
+#if (defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1) || defined __SSE__)
+#define A3_RAYPICKING_SSE
+#include <xmmintrin.h>
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+
+// find nearest sphere along ray; returns index or -1
+// same rules as single sphere test: the passing point must be in front of 
+//	the ray origin and within the radius
+inline int a3rayTestSphereSet_internal(p3real *param0_out, p3real *param1_out, const a3_Ray *ray, const a3_SphereSet *set)
+{
+	const float ox = ray->origin.x, oy = ray->origin.y, oz = ray->origin.z;
+	const float dx = ray->direction.x, dy = ray->direction.y, dz = ray->direction.z;
+	float best = (float)HUGE_VAL, lx, ly, lz, d, h_sq, b;
+	int bestIndex = -1;
+	unsigned int i = 0, k;
+
+#ifdef A3_RAYPICKING_SSE
+	const __m128 zero = _mm_setzero_ps(), four = _mm_set1_ps(4.0f);
+	const __m128 ox4 = _mm_set1_ps(ox), oy4 = _mm_set1_ps(oy), oz4 = _mm_set1_ps(oz);
+	const __m128 dx4 = _mm_set1_ps(dx), dy4 = _mm_set1_ps(dy), dz4 = _mm_set1_ps(dz);
+	__m128 best4 = _mm_set1_ps((float)HUGE_VAL), bestIndex4 = _mm_set1_ps(-1.0f);
+	__m128 index4 = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+	__m128 lx4, ly4, lz4, d4, b_sq4, t4, better;
+	float bestLane[4], bestIndexLane[4];
+
+	for (; i < set->count; i += 4, index4 = _mm_add_ps(index4, four))
+	{
+		lx4 = _mm_sub_ps(_mm_loadu_ps(set->centerX + i), ox4);
+		ly4 = _mm_sub_ps(_mm_loadu_ps(set->centerY + i), oy4);
+		lz4 = _mm_sub_ps(_mm_loadu_ps(set->centerZ + i), oz4);
+		d4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx4, dx4), _mm_mul_ps(ly4, dy4)), _mm_mul_ps(lz4, dz4));
+
+		// b^2 = r^2 - (L^2 - d^2)
+		b_sq4 = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(set->radiusSq + i), _mm_mul_ps(d4, d4)), 
+			_mm_add_ps(_mm_add_ps(_mm_mul_ps(lx4, lx4), _mm_mul_ps(ly4, ly4)), _mm_mul_ps(lz4, lz4)));
+		t4 = _mm_sub_ps(d4, _mm_sqrt_ps(_mm_max_ps(b_sq4, zero)));
+
+		// keep lanes that hit and are nearer than the best so far
+		better = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(d4, zero), _mm_cmpge_ps(b_sq4, zero)), _mm_cmplt_ps(t4, best4));
+		best4 = _mm_or_ps(_mm_and_ps(better, t4), _mm_andnot_ps(better, best4));
+		bestIndex4 = _mm_or_ps(_mm_and_ps(better, index4), _mm_andnot_ps(better, bestIndex4));
+	}
+
+	_mm_storeu_ps(bestLane, best4);
+	_mm_storeu_ps(bestIndexLane, bestIndex4);
+	for (k = 0; k < 4; ++k)
+	{
+		if (bestIndexLane[k] >= 0.0f && bestLane[k] < best)
+		{
+			best = bestLane[k];
+			bestIndex = (int)bestIndexLane[k];
+		}
+	}
+#endif	// A3_RAYPICKING_SSE
+
+	for (; i < set->count; ++i)
+	{
+		lx = set->centerX[i] - ox;
+		ly = set->centerY[i] - oy;
+		lz = set->centerZ[i] - oz;
+		d = lx * dx + ly * dy + lz * dz;
+		h_sq = lx * lx + ly * ly + lz * lz - d * d;
+		if (d >= 0.0f && set->radiusSq[i] >= h_sq && d - sqrtf(set->radiusSq[i] - h_sq) < best)
+		{
+			best = d - sqrtf(set->radiusSq[i] - h_sq);
+			bestIndex = i;
+		}
+	}
+
+	// both parameters for the winner
+	if (bestIndex >= 0)
+	{
+		k = (unsigned int)bestIndex;
+		lx = set->centerX[k] - ox;
+		ly = set->centerY[k] - oy;
+		lz = set->centerZ[k] - oz;
+		d = lx * dx + ly * dy + lz * dz;
+		h_sq = lx * lx + ly * ly + lz * lz - d * d;
+		b = set->radiusSq[k] > h_sq ? sqrtf(set->radiusSq[k] - h_sq) : 0.0f;
+		*param0_out = d - b;
+		*param1_out = d + b;
+	}
+	return bestIndex;
+}
+
+// fill hit points from parameters
+inline void a3raySetHit_internal(a3_RayHit *hit_out, const a3_Ray *ray)
+{
+	p3real4ProductS(hit_out->hit0.v, ray->direction.v, hit_out->param0);
+	p3real4ProductS(hit_out->hit1.v, ray->direction.v, hit_out->param1);
+	p3real4Add(hit_out->hit0.v, ray->origin.v);
+	p3real4Add(hit_out->hit1.v, ray->origin.v);
+}
+
+
+// capsule entry and exit along ray: the capsule is the union of its end 
+//	spheres and the cylinder between them, and since it is convex the ray 
+//	enters at the nearest entry and leaves at the farthest exit of these
+inline int a3rayTestCapsule_internal(p3real *param0_out, p3real *param1_out, const float *origin, const float *dir, const float *start, const float *axis, const float radius)
+{
+	const float r_sq = radius * radius;
+	const float baba = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	const float bard = axis[0] * dir[0] + axis[1] * dir[1] + axis[2] * dir[2];
+	float t0 = (float)HUGE_VAL, t1 = -(float)HUGE_VAL;
+	float lx, ly, lz, d, h_sq, b, a, baoa, k, c, h, t, y;
+	unsigned int i;
+
+	if (radius < 0.0f)
+		return 0;
+
+	// end spheres
+	for (i = 0; i < 2; ++i)
+	{
+		lx = start[0] + axis[0] * (float)i - origin[0];
+		ly = start[1] + axis[1] * (float)i - origin[1];
+		lz = start[2] + axis[2] * (float)i - origin[2];
+		d = lx * dir[0] + ly * dir[1] + lz * dir[2];
+		h_sq = lx * lx + ly * ly + lz * lz - d * d;
+		if (r_sq >= h_sq)
+		{
+			b = sqrtf(r_sq - h_sq);
+			if (d - b < t0)
+				t0 = d - b;
+			if (d + b > t1)
+				t1 = d + b;
+		}
+	}
+
+	// cylinder: solve a t^2 + 2 k t + c = 0 (skip if ray runs along axis)
+	a = baba - bard * bard;
+	if (a > baba * 1.0e-6f)
+	{
+		lx = origin[0] - start[0];
+		ly = origin[1] - start[1];
+		lz = origin[2] - start[2];
+		baoa = axis[0] * lx + axis[1] * ly + axis[2] * lz;
+		k = baba * (dir[0] * lx + dir[1] * ly + dir[2] * lz) - baoa * bard;
+		c = baba * (lx * lx + ly * ly + lz * lz - r_sq) - baoa * baoa;
+		h = k * k - a * c;
+		if (h >= 0.0f)
+		{
+			// only counts where the hit projects onto the segment
+			h = sqrtf(h);
+			t = (-k - h) / a;
+			y = baoa + t * bard;
+			if (y >= 0.0f && y <= baba && t < t0)
+				t0 = t;
+			t = (-k + h) / a;
+			y = baoa + t * bard;
+			if (y >= 0.0f && y <= baba && t > t1)
+				t1 = t;
+		}
+	}
+
+	if (t0 >= 0.0f && t1 >= t0)
+	{
+		*param0_out = t0;
+		*param1_out = t1;
+		return 1;
+	}
+	return 0;
+}
+
+// find nearest capsule along ray; returns index or -1
+inline int a3rayTestCapsuleSet_internal(p3real *param0_out, p3real *param1_out, const a3_Ray *ray, const a3_CapsuleSet *set)
+{
+	const float origin[3] = { ray->origin.x, ray->origin.y, ray->origin.z };
+	const float dir[3] = { ray->direction.x, ray->direction.y, ray->direction.z };
+	float start[3], axis[3], best = (float)HUGE_VAL;
+	p3real param0, param1;
+	int bestIndex = -1;
+	unsigned int i = 0, k;
+
+#ifdef A3_RAYPICKING_SSE
+	const __m128 zero = _mm_setzero_ps(), four = _mm_set1_ps(4.0f), eps = _mm_set1_ps(1.0e-6f);
+	const __m128 ox4 = _mm_set1_ps(origin[0]), oy4 = _mm_set1_ps(origin[1]), oz4 = _mm_set1_ps(origin[2]);
+	const __m128 dx4 = _mm_set1_ps(dir[0]), dy4 = _mm_set1_ps(dir[1]), dz4 = _mm_set1_ps(dir[2]);
+	__m128 best4 = _mm_set1_ps((float)HUGE_VAL), bestIndex4 = _mm_set1_ps(-1.0f);
+	__m128 index4 = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+	__m128 lx4, ly4, lz4, bx4, by4, bz4, r4, r_sq4, l_sq4, d4, b_sq4, t4, tc4;
+	__m128 baba4, bard4, baoa4, a4, k4, c4, h4, y4, valid, better;
+	float bestLane[4], bestIndexLane[4];
+
+	for (; i < set->count; i += 4, index4 = _mm_add_ps(index4, four))
+	{
+		// origin to start (L), axis (ba)
+		lx4 = _mm_sub_ps(_mm_loadu_ps(set->startX + i), ox4);
+		ly4 = _mm_sub_ps(_mm_loadu_ps(set->startY + i), oy4);
+		lz4 = _mm_sub_ps(_mm_loadu_ps(set->startZ + i), oz4);
+		bx4 = _mm_loadu_ps(set->axisX + i);
+		by4 = _mm_loadu_ps(set->axisY + i);
+		bz4 = _mm_loadu_ps(set->axisZ + i);
+		r4 = _mm_loadu_ps(set->radius + i);
+		r_sq4 = _mm_mul_ps(r4, r4);
+
+		// first end sphere
+		d4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx4, dx4), _mm_mul_ps(ly4, dy4)), _mm_mul_ps(lz4, dz4));
+		l_sq4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx4, lx4), _mm_mul_ps(ly4, ly4)), _mm_mul_ps(lz4, lz4));
+		b_sq4 = _mm_sub_ps(_mm_add_ps(r_sq4, _mm_mul_ps(d4, d4)), l_sq4);
+		tc4 = _mm_sub_ps(d4, _mm_sqrt_ps(_mm_max_ps(b_sq4, zero)));
+		valid = _mm_cmpge_ps(b_sq4, zero);
+		t4 = _mm_or_ps(_mm_and_ps(valid, tc4), _mm_andnot_ps(valid, _mm_set1_ps((float)HUGE_VAL)));
+
+		// cylinder (uses first sphere's terms: oa = -L)
+		baba4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx4, bx4), _mm_mul_ps(by4, by4)), _mm_mul_ps(bz4, bz4));
+		bard4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx4, dx4), _mm_mul_ps(by4, dy4)), _mm_mul_ps(bz4, dz4));
+		baoa4 = _mm_sub_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx4, lx4), _mm_mul_ps(by4, ly4)), _mm_mul_ps(bz4, lz4)));
+		a4 = _mm_sub_ps(baba4, _mm_mul_ps(bard4, bard4));
+		k4 = _mm_sub_ps(_mm_sub_ps(zero, _mm_mul_ps(baba4, d4)), _mm_mul_ps(baoa4, bard4));
+		c4 = _mm_sub_ps(_mm_mul_ps(baba4, _mm_sub_ps(l_sq4, r_sq4)), _mm_mul_ps(baoa4, baoa4));
+		h4 = _mm_sub_ps(_mm_mul_ps(k4, k4), _mm_mul_ps(a4, c4));
+		valid = _mm_and_ps(_mm_cmpge_ps(h4, zero), _mm_cmpgt_ps(a4, _mm_mul_ps(baba4, eps)));
+		tc4 = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero, k4), _mm_sqrt_ps(_mm_max_ps(h4, zero))), _mm_or_ps(_mm_and_ps(valid, a4), _mm_andnot_ps(valid, four)));
+		y4 = _mm_add_ps(baoa4, _mm_mul_ps(tc4, bard4));
+		valid = _mm_and_ps(_mm_and_ps(valid, _mm_cmplt_ps(tc4, t4)), _mm_and_ps(_mm_cmpge_ps(y4, zero), _mm_cmple_ps(y4, baba4)));
+		t4 = _mm_or_ps(_mm_and_ps(valid, tc4), _mm_andnot_ps(valid, t4));
+
+		// second end sphere
+		lx4 = _mm_add_ps(lx4, bx4);
+		ly4 = _mm_add_ps(ly4, by4);
+		lz4 = _mm_add_ps(lz4, bz4);
+		d4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx4, dx4), _mm_mul_ps(ly4, dy4)), _mm_mul_ps(lz4, dz4));
+		l_sq4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx4, lx4), _mm_mul_ps(ly4, ly4)), _mm_mul_ps(lz4, lz4));
+		b_sq4 = _mm_sub_ps(_mm_add_ps(r_sq4, _mm_mul_ps(d4, d4)), l_sq4);
+		tc4 = _mm_sub_ps(d4, _mm_sqrt_ps(_mm_max_ps(b_sq4, zero)));
+		valid = _mm_and_ps(_mm_cmpge_ps(b_sq4, zero), _mm_cmplt_ps(tc4, t4));
+		t4 = _mm_or_ps(_mm_and_ps(valid, tc4), _mm_andnot_ps(valid, t4));
+
+		// keep used lanes entering in front that are nearer than best so far
+		better = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(r4, zero), _mm_cmpge_ps(t4, zero)), _mm_cmplt_ps(t4, best4));
+		best4 = _mm_or_ps(_mm_and_ps(better, t4), _mm_andnot_ps(better, best4));
+		bestIndex4 = _mm_or_ps(_mm_and_ps(better, index4), _mm_andnot_ps(better, bestIndex4));
+	}
+
+	_mm_storeu_ps(bestLane, best4);
+	_mm_storeu_ps(bestIndexLane, bestIndex4);
+	for (k = 0; k < 4; ++k)
+	{
+		if (bestIndexLane[k] >= 0.0f && bestLane[k] < best)
+		{
+			best = bestLane[k];
+			bestIndex = (int)bestIndexLane[k];
+		}
+	}
+#endif	// A3_RAYPICKING_SSE
+
+	for (; i < set->count; ++i)
+	{
+		start[0] = set->startX[i];	start[1] = set->startY[i];	start[2] = set->startZ[i];
+		axis[0] = set->axisX[i];	axis[1] = set->axisY[i];	axis[2] = set->axisZ[i];
+		if (a3rayTestCapsule_internal(&param0, &param1, origin, dir, start, axis, set->radius[i]) && param0 < best)
+		{
+			best = param0;
+			bestIndex = i;
+		}
+	}
+
+	// both parameters for the winner
+	if (bestIndex >= 0)
+	{
+		k = (unsigned int)bestIndex;
+		start[0] = set->startX[k];	start[1] = set->startY[k];	start[2] = set->startZ[k];
+		axis[0] = set->axisX[k];	axis[1] = set->axisY[k];	axis[2] = set->axisZ[k];
+		if (!a3rayTestCapsule_internal(param0_out, param1_out, origin, dir, start, axis, set->radius[k]))
+		{
+			// grazing hit that only the batch caught
+			*param0_out = *param1_out = best;
+		}
+	}
+	return bestIndex;
+}
+
+// squared distance between segments p0 + s d0 and p1 + t d1, s and t in 
+//	[0, 1]; closest point method from Ericson, Real-Time Collision Detection
+inline float a3segmentDistanceSq_internal(const float *p0, const float *d0, const float *p1, const float *d1)
+{
+	const float rx = p0[0] - p1[0], ry = p0[1] - p1[1], rz = p0[2] - p1[2];
+	const float a = d0[0] * d0[0] + d0[1] * d0[1] + d0[2] * d0[2];
+	const float e = d1[0] * d1[0] + d1[1] * d1[1] + d1[2] * d1[2];
+	const float b = d0[0] * d1[0] + d0[1] * d1[1] + d0[2] * d1[2];
+	const float c = d0[0] * rx + d0[1] * ry + d0[2] * rz;
+	const float f = d1[0] * rx + d1[1] * ry + d1[2] * rz;
+	const float denom = a * e - b * b;
+	float s = 0.0f, t = 0.0f, x, y, z;
+
+	// unclamped closest point on first segment (zero if parallel)
+	if (denom > 1.0e-12f)
+	{
+		s = (b * f - c * e) / denom;
+		s = s < 0.0f ? 0.0f : s > 1.0f ? 1.0f : s;
+	}
+
+	// closest point on second segment to that, then back to the first
+	if (e > 1.0e-12f)
+	{
+		t = (b * s + f) / e;
+		t = t < 0.0f ? 0.0f : t > 1.0f ? 1.0f : t;
+	}
+	if (a > 1.0e-12f)
+	{
+		s = (b * t - c) / a;
+		s = s < 0.0f ? 0.0f : s > 1.0f ? 1.0f : s;
+	}
+
+	x = rx + d0[0] * s - d1[0] * t;
+	y = ry + d0[1] * s - d1[1] * t;
+	z = rz + d0[2] * s - d1[2] * t;
+	return (x * x + y * y + z * z);
+}
+
+// find capsules in set within reach of a segment and radius; stores 
+//	indices (or pairs with the given first index if not negative), 
+//	returns the running count
+inline unsigned int a3capsuleTestCapsuleSet_internal(int *index_out, const unsigned int indexCapacity, unsigned int count, const int pairIndex, const float *start, const float *axis, const float radius, const a3_CapsuleSet *set)
+{
+	float p1[3], d1[3], reach;
+	unsigned int i = 0;
+
+#ifdef A3_RAYPICKING_SSE
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), eps = _mm_set1_ps(1.0e-12f);
+	const __m128 px4 = _mm_set1_ps(start[0]), py4 = _mm_set1_ps(start[1]), pz4 = _mm_set1_ps(start[2]);
+	const __m128 ax4 = _mm_set1_ps(axis[0]), ay4 = _mm_set1_ps(axis[1]), az4 = _mm_set1_ps(axis[2]);
+	const float a = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	const __m128 a4 = _mm_set1_ps(a), aInv4 = _mm_set1_ps(a > 1.0e-12f ? 1.0f / a : 0.0f), r0 = _mm_set1_ps(radius);
+	__m128 rx4, ry4, rz4, bx4, by4, bz4, r4, e4, b4, c4, f4, denom4, s4, t4, valid, hit;
+	int mask;
+	unsigned int k;
+
+	for (; i < set->count; i += 4)
+	{
+		rx4 = _mm_sub_ps(px4, _mm_loadu_ps(set->startX + i));
+		ry4 = _mm_sub_ps(py4, _mm_loadu_ps(set->startY + i));
+		rz4 = _mm_sub_ps(pz4, _mm_loadu_ps(set->startZ + i));
+		bx4 = _mm_loadu_ps(set->axisX + i);
+		by4 = _mm_loadu_ps(set->axisY + i);
+		bz4 = _mm_loadu_ps(set->axisZ + i);
+		r4 = _mm_loadu_ps(set->radius + i);
+
+		e4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx4, bx4), _mm_mul_ps(by4, by4)), _mm_mul_ps(bz4, bz4));
+		b4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax4, bx4), _mm_mul_ps(ay4, by4)), _mm_mul_ps(az4, bz4));
+		c4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax4, rx4), _mm_mul_ps(ay4, ry4)), _mm_mul_ps(az4, rz4));
+		f4 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx4, rx4), _mm_mul_ps(by4, ry4)), _mm_mul_ps(bz4, rz4));
+		denom4 = _mm_sub_ps(_mm_mul_ps(a4, e4), _mm_mul_ps(b4, b4));
+
+		// same steps as scalar, with guarded divisions
+		valid = _mm_cmpgt_ps(denom4, eps);
+		s4 = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(b4, f4), _mm_mul_ps(c4, e4)), _mm_or_ps(_mm_and_ps(valid, denom4), _mm_andnot_ps(valid, one)));
+		s4 = _mm_and_ps(valid, _mm_min_ps(_mm_max_ps(s4, zero), one));
+		valid = _mm_cmpgt_ps(e4, eps);
+		t4 = _mm_div_ps(_mm_add_ps(_mm_mul_ps(b4, s4), f4), _mm_or_ps(_mm_and_ps(valid, e4), _mm_andnot_ps(valid, one)));
+		t4 = _mm_and_ps(valid, _mm_min_ps(_mm_max_ps(t4, zero), one));
+		if (a > 1.0e-12f)
+			s4 = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(b4, t4), c4), aInv4), zero), one);
+
+		rx4 = _mm_sub_ps(_mm_add_ps(rx4, _mm_mul_ps(ax4, s4)), _mm_mul_ps(bx4, t4));
+		ry4 = _mm_sub_ps(_mm_add_ps(ry4, _mm_mul_ps(ay4, s4)), _mm_mul_ps(by4, t4));
+		rz4 = _mm_sub_ps(_mm_add_ps(rz4, _mm_mul_ps(az4, s4)), _mm_mul_ps(bz4, t4));
+		r4 = _mm_add_ps(r4, r0);
+		hit = _mm_cmple_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx4, rx4), _mm_mul_ps(ry4, ry4)), _mm_mul_ps(rz4, rz4)), _mm_mul_ps(r4, r4));
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_loadu_ps(set->radius + i), zero));
+
+		for (mask = _mm_movemask_ps(hit), k = 0; mask; mask >>= 1, ++k)
+		{
+			if (mask & 1)
+			{
+				if (pairIndex < 0 && count < indexCapacity)
+					index_out[count] = (int)(i + k);
+				else if (pairIndex >= 0 && count < indexCapacity)
+				{
+					index_out[count * 2 + 0] = pairIndex;
+					index_out[count * 2 + 1] = (int)(i + k);
+				}
+				++count;
+			}
+		}
+	}
+#endif	// A3_RAYPICKING_SSE
+
+	for (; i < set->count; ++i)
+	{
+		p1[0] = set->startX[i];	p1[1] = set->startY[i];	p1[2] = set->startZ[i];
+		d1[0] = set->axisX[i];	d1[1] = set->axisY[i];	d1[2] = set->axisZ[i];
+		reach = radius + set->radius[i];
+		if (set->radius[i] >= 0.0f && a3segmentDistanceSq_internal(start, axis, p1, d1) <= reach * reach)
+		{
+			if (pairIndex < 0 && count < indexCapacity)
+				index_out[count] = (int)i;
+			else if (pairIndex >= 0 && count < indexCapacity)
+			{
+				index_out[count * 2 + 0] = pairIndex;
+				index_out[count * 2 + 1] = (int)i;
+			}
+			++count;
+		}
+	}
+	return count;
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -131,4 +535,327 @@ extern inline int a3rayTestSphere(a3_RayHit *hit_out, const a3_Ray *ray, const a
 }
 
 
+//-----------------------------------------------------------------------------
+
+// create sphere set
+extern inline int a3sphereSetCreate(a3_SphereSet *set_out, const unsigned int capacity)
+{
+	if (set_out && capacity && !set_out->centerX)
+	{
+		// round up to multiple of 4 so batches never run off the end
+		const unsigned int padded = (capacity + 3) & ~3u;
+		unsigned int i;
+		set_out->centerX = (float *)malloc(4 * padded * sizeof(float));
+		set_out->centerY = set_out->centerX + padded;
+		set_out->centerZ = set_out->centerY + padded;
+		set_out->radiusSq = set_out->centerZ + padded;
+		for (i = 0; i < padded; ++i)
+		{
+			set_out->centerX[i] = set_out->centerY[i] = set_out->centerZ[i] = 0.0f;
+			set_out->radiusSq[i] = -1.0f;
+		}
+		set_out->count = 0;
+		set_out->capacity = padded;
+		return padded;
+	}
+	return 0;
+}
+
+// release sphere set
+extern inline int a3sphereSetRelease(a3_SphereSet *set)
+{
+	if (set && set->centerX)
+	{
+		free(set->centerX);
+		set->centerX = set->centerY = set->centerZ = set->radiusSq = 0;
+		set->count = set->capacity = 0;
+		return 1;
+	}
+	return 0;
+}
+
+// set a single sphere
+extern inline int a3sphereSetStore(a3_SphereSet *set, const unsigned int index, const a3_Sphere *sphere)
+{
+	if (set && set->centerX && sphere && index < set->capacity)
+	{
+		set->centerX[index] = sphere->center.x;
+		set->centerY[index] = sphere->center.y;
+		set->centerZ[index] = sphere->center.z;
+		set->radiusSq[index] = sphere->radius * sphere->radius;
+		if (index >= set->count)
+			set->count = index + 1;
+		return 1;
+	}
+	return 0;
+}
+
+// fill set from transforms
+extern inline int a3sphereSetFromTransforms(a3_SphereSet *set, const p3mat4 *transforms, const unsigned int count, const p3real radius)
+{
+	if (set && set->centerX && transforms && count <= set->capacity)
+	{
+		const float r_sq = radius * radius;
+		unsigned int i;
+		for (i = 0; i < count; ++i)
+		{
+			set->centerX[i] = transforms[i].v3.x;
+			set->centerY[i] = transforms[i].v3.y;
+			set->centerZ[i] = transforms[i].v3.z;
+			set->radiusSq[i] = r_sq;
+		}
+
+		// anything left over from before must not hit
+		for (; i < set->count; ++i)
+			set->radiusSq[i] = -1.0f;
+		set->count = count;
+		return count;
+	}
+	return 0;
+}
+
+// pick nearest sphere in set
+extern inline int a3rayTestSphereSet(a3_RayHit *hit_out, int *index_out, const a3_Ray *ray, const a3_SphereSet *set)
+{
+	if (hit_out && index_out && ray && set && set->centerX)
+	{
+		*index_out = a3rayTestSphereSet_internal(&hit_out->param0, &hit_out->param1, ray, set);
+		if (*index_out >= 0)
+		{
+			a3raySetHit_internal(hit_out, ray);
+			return 1;
+		}
+
+		// bad result
+		hit_out->hit0 = hit_out->hit1 = p3zeroVec4;
+		hit_out->param0 = hit_out->param1 = realZero;
+	}
+	return 0;
+}
+
+// pick nearest sphere in set for each ray
+extern inline int a3rayTestSphereSetBatch(a3_RayHit *hit_out, int *index_out, const a3_Ray *rays, const unsigned int rayCount, const a3_SphereSet *set)
+{
+	if (hit_out && index_out && rays && set && set->centerX)
+	{
+		unsigned int i;
+		int result = 0;
+		for (i = 0; i < rayCount; ++i)
+			result += a3rayTestSphereSet(hit_out + i, index_out + i, rays + i, set);
+		return result;
+	}
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// pick against capsule
+extern inline int a3rayTestCapsule(a3_RayHit *hit_out, const a3_Ray *ray, const a3_Capsule *capsule)
+{
+	if (hit_out && ray && capsule)
+	{
+		const float origin[3] = { ray->origin.x, ray->origin.y, ray->origin.z };
+		const float dir[3] = { ray->direction.x, ray->direction.y, ray->direction.z };
+		const float start[3] = { capsule->point0.x, capsule->point0.y, capsule->point0.z };
+		const float axis[3] = { capsule->point1.x - start[0], capsule->point1.y - start[1], capsule->point1.z - start[2] };
+		if (a3rayTestCapsule_internal(&hit_out->param0, &hit_out->param1, origin, dir, start, axis, capsule->radius))
+		{
+			a3raySetHit_internal(hit_out, ray);
+			return 1;
+		}
+
+		// bad result
+		hit_out->hit0 = hit_out->hit1 = p3zeroVec4;
+		hit_out->param0 = hit_out->param1 = realZero;
+	}
+	return 0;
+}
+
+// test if two capsules overlap
+extern inline int a3capsuleTestCapsule(const a3_Capsule *capsule0, const a3_Capsule *capsule1)
+{
+	if (capsule0 && capsule1 && capsule0->radius >= realZero && capsule1->radius >= realZero)
+	{
+		const float p0[3] = { capsule0->point0.x, capsule0->point0.y, capsule0->point0.z };
+		const float d0[3] = { capsule0->point1.x - p0[0], capsule0->point1.y - p0[1], capsule0->point1.z - p0[2] };
+		const float p1[3] = { capsule1->point0.x, capsule1->point0.y, capsule1->point0.z };
+		const float d1[3] = { capsule1->point1.x - p1[0], capsule1->point1.y - p1[1], capsule1->point1.z - p1[2] };
+		const float reach = capsule0->radius + capsule1->radius;
+		return (a3segmentDistanceSq_internal(p0, d0, p1, d1) <= reach * reach);
+	}
+	return 0;
+}
+
+
+// create capsule set
+extern inline int a3capsuleSetCreate(a3_CapsuleSet *set_out, const unsigned int capacity)
+{
+	if (set_out && capacity && !set_out->startX)
+	{
+		// round up to multiple of 4 so batches never run off the end
+		const unsigned int padded = (capacity + 3) & ~3u;
+		unsigned int i;
+		set_out->startX = (float *)malloc(7 * padded * sizeof(float));
+		set_out->startY = set_out->startX + padded;
+		set_out->startZ = set_out->startY + padded;
+		set_out->axisX = set_out->startZ + padded;
+		set_out->axisY = set_out->axisX + padded;
+		set_out->axisZ = set_out->axisY + padded;
+		set_out->radius = set_out->axisZ + padded;
+		for (i = 0; i < padded; ++i)
+		{
+			set_out->startX[i] = set_out->startY[i] = set_out->startZ[i] = 0.0f;
+			set_out->axisX[i] = set_out->axisY[i] = set_out->axisZ[i] = 0.0f;
+			set_out->radius[i] = -1.0f;
+		}
+		set_out->count = 0;
+		set_out->capacity = padded;
+		return padded;
+	}
+	return 0;
+}
+
+// release capsule set
+extern inline int a3capsuleSetRelease(a3_CapsuleSet *set)
+{
+	if (set && set->startX)
+	{
+		free(set->startX);
+		set->startX = set->startY = set->startZ = 0;
+		set->axisX = set->axisY = set->axisZ = set->radius = 0;
+		set->count = set->capacity = 0;
+		return 1;
+	}
+	return 0;
+}
+
+// set a single capsule
+extern inline int a3capsuleSetStore(a3_CapsuleSet *set, const unsigned int index, const a3_Capsule *capsule)
+{
+	if (set && set->startX && capsule && index < set->capacity)
+	{
+		set->startX[index] = capsule->point0.x;
+		set->startY[index] = capsule->point0.y;
+		set->startZ[index] = capsule->point0.z;
+		set->axisX[index] = capsule->point1.x - capsule->point0.x;
+		set->axisY[index] = capsule->point1.y - capsule->point0.y;
+		set->axisZ[index] = capsule->point1.z - capsule->point0.z;
+		set->radius[index] = capsule->radius;
+		if (index >= set->count)
+			set->count = index + 1;
+		return 1;
+	}
+	return 0;
+}
+
+// fill set from hierarchy bones
+extern inline int a3capsuleSetFromHierarchy(a3_CapsuleSet *set, const a3_Hierarchy *hierarchy, const p3mat4 *objectSpace, const p3real radius)
+{
+	if (set && set->startX && hierarchy && hierarchy->nodes && objectSpace && hierarchy->numNodes <= set->capacity)
+	{
+		const unsigned int count = hierarchy->numNodes;
+		const p3mat4 *parent;
+		unsigned int i;
+		int parentIndex;
+		for (i = 0; i < count; ++i)
+		{
+			parentIndex = hierarchy->nodes[i].parentIndex;
+			if (parentIndex >= 0)
+			{
+				parent = objectSpace + parentIndex;
+				set->startX[i] = parent->v3.x;
+				set->startY[i] = parent->v3.y;
+				set->startZ[i] = parent->v3.z;
+				set->axisX[i] = objectSpace[i].v3.x - parent->v3.x;
+				set->axisY[i] = objectSpace[i].v3.y - parent->v3.y;
+				set->axisZ[i] = objectSpace[i].v3.z - parent->v3.z;
+				set->radius[i] = radius;
+			}
+			else
+			{
+				set->startX[i] = objectSpace[i].v3.x;
+				set->startY[i] = objectSpace[i].v3.y;
+				set->startZ[i] = objectSpace[i].v3.z;
+				set->axisX[i] = set->axisY[i] = set->axisZ[i] = 0.0f;
+				set->radius[i] = -1.0f;
+			}
+		}
+
+		// anything left over from before must not hit
+		for (; i < set->count; ++i)
+			set->radius[i] = -1.0f;
+		set->count = count;
+		return count;
+	}
+	return 0;
+}
+
+// pick nearest capsule in set
+extern inline int a3rayTestCapsuleSet(a3_RayHit *hit_out, int *index_out, const a3_Ray *ray, const a3_CapsuleSet *set)
+{
+	if (hit_out && index_out && ray && set && set->startX)
+	{
+		*index_out = a3rayTestCapsuleSet_internal(&hit_out->param0, &hit_out->param1, ray, set);
+		if (*index_out >= 0)
+		{
+			a3raySetHit_internal(hit_out, ray);
+			return 1;
+		}
+
+		// bad result
+		hit_out->hit0 = hit_out->hit1 = p3zeroVec4;
+		hit_out->param0 = hit_out->param1 = realZero;
+	}
+	return 0;
+}
+
+// pick nearest capsule in set for each ray
+extern inline int a3rayTestCapsuleSetBatch(a3_RayHit *hit_out, int *index_out, const a3_Ray *rays, const unsigned int rayCount, const a3_CapsuleSet *set)
+{
+	if (hit_out && index_out && rays && set && set->startX)
+	{
+		unsigned int i;
+		int result = 0;
+		for (i = 0; i < rayCount; ++i)
+			result += a3rayTestCapsuleSet(hit_out + i, index_out + i, rays + i, set);
+		return result;
+	}
+	return 0;
+}
+
+// find capsules in set overlapping capsule
+extern inline int a3capsuleTestCapsuleSet(int *index_out, const unsigned int indexCapacity, const a3_Capsule *capsule, const a3_CapsuleSet *set)
+{
+	if (index_out && capsule && set && set->startX && capsule->radius >= realZero)
+	{
+		const float start[3] = { capsule->point0.x, capsule->point0.y, capsule->point0.z };
+		const float axis[3] = { capsule->point1.x - start[0], capsule->point1.y - start[1], capsule->point1.z - start[2] };
+		return a3capsuleTestCapsuleSet_internal(index_out, indexCapacity, 0, -1, start, axis, capsule->radius, set);
+	}
+	return 0;
+}
+
+// find overlapping pairs between sets
+extern inline int a3capsuleSetTestCapsuleSet(int *pairs_out, const unsigned int pairCapacity, const a3_CapsuleSet *set0, const a3_CapsuleSet *set1)
+{
+	if (pairs_out && set0 && set1 && set0->startX && set1->startX)
+	{
+		float start[3], axis[3];
+		unsigned int i, count = 0;
+		for (i = 0; i < set0->count; ++i)
+		{
+			if (set0->radius[i] >= 0.0f)
+			{
+				start[0] = set0->startX[i];	start[1] = set0->startY[i];	start[2] = set0->startZ[i];
+				axis[0] = set0->axisX[i];	axis[1] = set0->axisY[i];	axis[2] = set0->axisZ[i];
+				count = a3capsuleTestCapsuleSet_internal(pairs_out, pairCapacity, count, (int)i, start, axis, set0->radius[i], set1);
+			}
+		}
+		return count;
+	}
+	return 0;
+}
+
+
 //-----------------------------------------------------------------------------
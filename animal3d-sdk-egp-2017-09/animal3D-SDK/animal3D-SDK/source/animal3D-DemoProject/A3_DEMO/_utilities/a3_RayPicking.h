@@ -29,6 +29,9 @@
 // math library
 #include "P3DM/P3DM.h"
 
+// A3 hierarchy
+#include "animal3D/a3animation/a3_Hierarchy.h"
+
 
 //-----------------------------------------------------------------------------
 
@@ -39,6 +42,9 @@ extern "C"
 	typedef struct a3_Ray		a3_Ray;
 	typedef struct a3_RayHit	a3_RayHit;
 	typedef struct a3_Sphere	a3_Sphere;
+	typedef struct a3_SphereSet	a3_SphereSet;
+	typedef struct a3_Capsule		a3_Capsule;
+	typedef struct a3_CapsuleSet	a3_CapsuleSet;
 #endif	// __cplusplus
 
 	
@@ -66,6 +72,35 @@ extern "C"
 	};
 
 
+	// set of spheres stored as separate arrays for batch tests
+	//	(arrays are padded to a multiple of 4; padding never hits)
+	struct a3_SphereSet
+	{
+		float *centerX, *centerY, *centerZ;	// center coordinates
+		float *radiusSq;					// squared radii
+		unsigned int count, capacity;		// used and allocated spheres
+	};
+
+
+	// capsule: all points within radius of segment
+	struct a3_Capsule
+	{
+		p3vec4 point0, point1;	// segment end points (w = 1)
+		p3real radius;			// radius around segment
+	};
+
+
+	// set of capsules stored as separate arrays for batch tests
+	//	(arrays are padded to a multiple of 4; negative radius never hits)
+	struct a3_CapsuleSet
+	{
+		float *startX, *startY, *startZ;	// first segment point
+		float *axisX, *axisY, *axisZ;		// second point minus first
+		float *radius;						// radii (negative if unused)
+		unsigned int count, capacity;		// used and allocated capsules
+	};
+
+
 //-----------------------------------------------------------------------------
 
 	// create ray given start and end points
@@ -78,6 +113,66 @@ extern "C"
 	inline int a3rayTestSphere(a3_RayHit *hit_out, const a3_Ray *ray, const a3_Sphere *sphere);
 
 
+	// create sphere set with space for the given count
+	inline int a3sphereSetCreate(a3_SphereSet *set_out, const unsigned int capacity);
+
+	// release sphere set
+	inline int a3sphereSetRelease(a3_SphereSet *set);
+
+	// set a single sphere in set
+	inline int a3sphereSetStore(a3_SphereSet *set, const unsigned int index, const a3_Sphere *sphere);
+
+	// fill set with spheres of the same radius at the translation of each 
+	//	transform (e.g. joints in object space; test with an object-space ray)
+	inline int a3sphereSetFromTransforms(a3_SphereSet *set, const p3mat4 *transforms, const unsigned int count, const p3real radius);
+
+	// pick nearest sphere in set; index_out receives the sphere's index
+	inline int a3rayTestSphereSet(a3_RayHit *hit_out, int *index_out, const a3_Ray *ray, const a3_SphereSet *set);
+
+	// pick nearest sphere in set for each ray; index is -1 for each miss
+	//	returns number of rays that hit
+	inline int a3rayTestSphereSetBatch(a3_RayHit *hit_out, int *index_out, const a3_Ray *rays, const unsigned int rayCount, const a3_SphereSet *set);
+
+
+	// pick against capsule; hits only if the capsule is in front of the 
+	//	ray origin (not if the origin is inside)
+	inline int a3rayTestCapsule(a3_RayHit *hit_out, const a3_Ray *ray, const a3_Capsule *capsule);
+
+	// test if two capsules overlap
+	inline int a3capsuleTestCapsule(const a3_Capsule *capsule0, const a3_Capsule *capsule1);
+
+
+	// create capsule set with space for the given count
+	inline int a3capsuleSetCreate(a3_CapsuleSet *set_out, const unsigned int capacity);
+
+	// release capsule set
+	inline int a3capsuleSetRelease(a3_CapsuleSet *set);
+
+	// set a single capsule in set
+	inline int a3capsuleSetStore(a3_CapsuleSet *set, const unsigned int index, const a3_Capsule *capsule);
+
+	// fill set with one capsule per bone: capsule at each node's index spans 
+	//	from its parent's translation to its own (roots never hit)
+	inline int a3capsuleSetFromHierarchy(a3_CapsuleSet *set, const a3_Hierarchy *hierarchy, const p3mat4 *objectSpace, const p3real radius);
+
+	// pick nearest capsule in set; index_out receives the capsule's index 
+	//	(node index if built from hierarchy)
+	inline int a3rayTestCapsuleSet(a3_RayHit *hit_out, int *index_out, const a3_Ray *ray, const a3_CapsuleSet *set);
+
+	// pick nearest capsule in set for each ray; index is -1 for each miss
+	//	returns number of rays that hit
+	inline int a3rayTestCapsuleSetBatch(a3_RayHit *hit_out, int *index_out, const a3_Ray *rays, const unsigned int rayCount, const a3_CapsuleSet *set);
+
+	// find capsules in set overlapping a capsule; stores up to the given 
+	//	number of indices and returns the total overlap count
+	inline int a3capsuleTestCapsuleSet(int *index_out, const unsigned int indexCapacity, const a3_Capsule *capsule, const a3_CapsuleSet *set);
+
+	// find overlapping pairs between two sets (e.g. two skeletons); stores 
+	//	up to the given number of pairs (two indices each) and returns the 
+	//	total pair count
+	inline int a3capsuleSetTestCapsuleSet(int *pairs_out, const unsigned int pairCapacity, const a3_CapsuleSet *set0, const a3_CapsuleSet *set1);
+
+
 //-----------------------------------------------------------------------------
 
 
@@ -0,0 +1,461 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_RayPickingBVH.c
+	Implementation of picking hierarchy.
+*/
+
+#include "a3_RayPickingBVH.h"
+
+#include <stdlib.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// build settings
+#define a3bvh_binCount		12
+#define a3bvh_leafSize		2
+#define a3bvh_leafSizeMax	8
+#define a3bvh_depthMax		63
+#define a3bvh_stackSize		(a3bvh_depthMax + 1)	// enough for any tree the build makes
+#define a3bvh_dirInvMax		1.0e30f
+
+
+inline void a3bvhBoundsReset_internal(float *bmin, float *bmax)
+{
+	bmin[0] = bmin[1] = bmin[2] = (float)HUGE_VAL;
+	bmax[0] = bmax[1] = bmax[2] = -(float)HUGE_VAL;
+}
+
+inline void a3bvhBoundsGrow_internal(float *bmin, float *bmax, const float *addMin, const float *addMax)
+{
+	unsigned int k;
+	for (k = 0; k < 3; ++k)
+	{
+		if (addMin[k] < bmin[k])
+			bmin[k] = addMin[k];
+		if (addMax[k] > bmax[k])
+			bmax[k] = addMax[k];
+	}
+}
+
+inline float a3bvhBoundsArea_internal(const float *bmin, const float *bmax)
+{
+	const float x = bmax[0] - bmin[0], y = bmax[1] - bmin[1], z = bmax[2] - bmin[2];
+	return (x < 0.0f ? 0.0f : (x * y + y * z + z * x));
+}
+
+inline float a3bvhCentroid_internal(const float *primBounds, const unsigned int axis)
+{
+	return (primBounds[axis] + primBounds[axis + 3]);
+}
+
+// build subtree over primitive slots [first, first + count), return node
+//	(nodes at the maximum depth become leaves, however big, so traversal 
+//	never runs out of stack)
+inline unsigned int a3bvhBuild_internal(a3_BVH *bvh, const unsigned int first, const unsigned int count, const unsigned int depth)
+{
+	const unsigned int nodeIndex = bvh->nodeCount++;
+	a3_BVHNode *node = bvh->node + nodeIndex;
+	float cmin[3], cmax[3], c[3];
+	const float *b;
+	unsigned int i, axis, split, countL, mid;
+
+	// node and centroid bounds
+	a3bvhBoundsReset_internal(node->boundsMin, node->boundsMax);
+	a3bvhBoundsReset_internal(cmin, cmax);
+	for (i = first; i < first + count; ++i)
+	{
+		b = bvh->primBounds + bvh->primIndex[i] * 6;
+		a3bvhBoundsGrow_internal(node->boundsMin, node->boundsMax, b, b + 3);
+		c[0] = a3bvhCentroid_internal(b, 0);
+		c[1] = a3bvhCentroid_internal(b, 1);
+		c[2] = a3bvhCentroid_internal(b, 2);
+		a3bvhBoundsGrow_internal(cmin, cmax, c, c);
+	}
+
+	// split along widest centroid axis
+	axis = (cmax[0] - cmin[0] > cmax[1] - cmin[1]) ? 0 : 1;
+	if (cmax[2] - cmin[2] > cmax[axis] - cmin[axis])
+		axis = 2;
+
+	if (depth > bvh->depth)
+		bvh->depth = depth;
+
+	if (count > a3bvh_leafSize && cmax[axis] > cmin[axis] && depth < a3bvh_depthMax)
+	{
+		// bin centroids and evaluate cost of each split plane
+		unsigned int binCount[a3bvh_binCount] = { 0 }, bin, bestSplit = 0;
+		float binMin[a3bvh_binCount][3], binMax[a3bvh_binCount][3];
+		float accMin[3], accMax[3], areaL[a3bvh_binCount], cost, bestCost = (float)HUGE_VAL;
+		const float scale = (float)a3bvh_binCount / (cmax[axis] - cmin[axis]);
+		unsigned int countBelow;
+
+		for (bin = 0; bin < a3bvh_binCount; ++bin)
+			a3bvhBoundsReset_internal(binMin[bin], binMax[bin]);
+		for (i = first; i < first + count; ++i)
+		{
+			b = bvh->primBounds + bvh->primIndex[i] * 6;
+			bin = (unsigned int)((a3bvhCentroid_internal(b, axis) - cmin[axis]) * scale);
+			if (bin >= a3bvh_binCount)
+				bin = a3bvh_binCount - 1;
+			++binCount[bin];
+			a3bvhBoundsGrow_internal(binMin[bin], binMax[bin], b, b + 3);
+		}
+
+		// sweep left to right for left areas, right to left for cost
+		a3bvhBoundsReset_internal(accMin, accMax);
+		for (bin = 0; bin < a3bvh_binCount - 1; ++bin)
+		{
+			a3bvhBoundsGrow_internal(accMin, accMax, binMin[bin], binMax[bin]);
+			areaL[bin] = a3bvhBoundsArea_internal(accMin, accMax);
+		}
+		a3bvhBoundsReset_internal(accMin, accMax);
+		countBelow = count;
+		for (bin = a3bvh_binCount - 1; bin > 0; --bin)
+		{
+			a3bvhBoundsGrow_internal(accMin, accMax, binMin[bin], binMax[bin]);
+			countBelow -= binCount[bin];
+			cost = areaL[bin - 1] * (float)countBelow + 
+				a3bvhBoundsArea_internal(accMin, accMax) * (float)(count - countBelow);
+			if (countBelow && countBelow < count && cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = bin;
+			}
+		}
+
+		// split if cheaper than leaf (or if leaf would be too big)
+		if (bestSplit && (bestCost < a3bvhBoundsArea_internal(node->boundsMin, node->boundsMax) * (float)count || count > a3bvh_leafSizeMax))
+		{
+			// partition slots by bin
+			split = first + count;
+			for (i = first; i < split; )
+			{
+				b = bvh->primBounds + bvh->primIndex[i] * 6;
+				bin = (unsigned int)((a3bvhCentroid_internal(b, axis) - cmin[axis]) * scale);
+				if (bin >= a3bvh_binCount)
+					bin = a3bvh_binCount - 1;
+				if (bin < bestSplit)
+					++i;
+				else
+				{
+					mid = bvh->primIndex[i];
+					bvh->primIndex[i] = bvh->primIndex[--split];
+					bvh->primIndex[split] = mid;
+				}
+			}
+			countL = split - first;
+
+			// children (pointer may be stale after recursion, index is not)
+			node->count = 0;
+			a3bvhBuild_internal(bvh, first, countL, depth + 1);
+			i = a3bvhBuild_internal(bvh, split, count - countL, depth + 1);
+			bvh->node[nodeIndex].offset = i;
+			return nodeIndex;
+		}
+	}
+
+	// leaf
+	node->offset = first;
+	node->count = count;
+	return nodeIndex;
+}
+
+// reciprocal of a direction component, clamped to a finite value; zero 
+//	(or tiny) components come out at the clamp and mark the ray parallel 
+//	to that slab, so the slab test never computes 0 * inf = NaN
+inline float a3bvhDirInv_internal(const float d)
+{
+	return (d > 1.0f / a3bvh_dirInvMax) ? 1.0f / d : (d < -1.0f / a3bvh_dirInvMax) ? 1.0f / d : a3bvh_dirInvMax;
+}
+
+// slab test: entry param if ray hits box before limit, otherwise negative
+inline float a3bvhRayBox_internal(const float *bmin, const float *bmax, const float *origin, const float *dirInv, const float limit)
+{
+	float t0 = 0.0f, t1 = limit, tNear, tFar, tmp;
+	unsigned int k;
+	for (k = 0; k < 3; ++k)
+	{
+		// parallel: inside the slab (including its planes) or never
+		if (dirInv[k] >= a3bvh_dirInvMax)
+		{
+			if (origin[k] < bmin[k] || origin[k] > bmax[k])
+				return -1.0f;
+			continue;
+		}
+		tNear = (bmin[k] - origin[k]) * dirInv[k];
+		tFar = (bmax[k] - origin[k]) * dirInv[k];
+		if (tNear > tFar)
+		{
+			tmp = tNear;
+			tNear = tFar;
+			tFar = tmp;
+		}
+		if (tNear > t0)
+			t0 = tNear;
+		if (tFar < t1)
+			t1 = tFar;
+		if (t0 > t1)
+			return -1.0f;
+	}
+	return t0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// create hierarchy
+extern inline int a3bvhCreate(a3_BVH *bvh_out, const unsigned int primCount)
+{
+	if (bvh_out && primCount && !bvh_out->node)
+	{
+		// at most (2n - 1) nodes
+		unsigned int i;
+		bvh_out->node = (a3_BVHNode *)malloc((2 * primCount - 1) * sizeof(a3_BVHNode) + 
+			primCount * (sizeof(unsigned int) + 6 * sizeof(float)));
+		bvh_out->primBounds = (float *)(bvh_out->node + 2 * primCount - 1);
+		bvh_out->primIndex = (unsigned int *)(bvh_out->primBounds + 6 * primCount);
+		bvh_out->primCount = primCount;
+		bvh_out->nodeCount = 0;
+		bvh_out->depth = 0;
+		for (i = 0; i < primCount; ++i)
+		{
+			bvh_out->primIndex[i] = i;
+			a3bvhBoundsReset_internal(bvh_out->primBounds + i * 6, bvh_out->primBounds + i * 6 + 3);
+		}
+		return primCount;
+	}
+	return -1;
+}
+
+// release hierarchy
+extern inline int a3bvhRelease(a3_BVH *bvh)
+{
+	if (bvh && bvh->node)
+	{
+		free(bvh->node);
+		bvh->node = 0;
+		bvh->primIndex = 0;
+		bvh->primBounds = 0;
+		bvh->nodeCount = bvh->primCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+// set bounds of single primitive
+extern inline int a3bvhSetPrimitiveBounds(a3_BVH *bvh, const unsigned int primIndex, const p3vec3 *boundsMin, const p3vec3 *boundsMax)
+{
+	if (bvh && bvh->node && boundsMin && boundsMax && primIndex < bvh->primCount)
+	{
+		float *b = bvh->primBounds + primIndex * 6;
+		b[0] = boundsMin->x;	b[1] = boundsMin->y;	b[2] = boundsMin->z;
+		b[3] = boundsMax->x;	b[4] = boundsMax->y;	b[5] = boundsMax->z;
+		return 1;
+	}
+	return -1;
+}
+
+// set bounds from transforms
+extern inline int a3bvhSetBoundsFromTransforms(a3_BVH *bvh, const p3mat4 *transforms, const p3real radius)
+{
+	if (bvh && bvh->node && transforms)
+	{
+		float *b = bvh->primBounds;
+		unsigned int i;
+		for (i = 0; i < bvh->primCount; ++i, ++transforms, b += 6)
+		{
+			b[0] = transforms->v3.x - radius;	b[3] = transforms->v3.x + radius;
+			b[1] = transforms->v3.y - radius;	b[4] = transforms->v3.y + radius;
+			b[2] = transforms->v3.z - radius;	b[5] = transforms->v3.z + radius;
+		}
+		return bvh->primCount;
+	}
+	return -1;
+}
+
+// build
+extern inline int a3bvhBuild(a3_BVH *bvh)
+{
+	if (bvh && bvh->node)
+	{
+		bvh->nodeCount = 0;
+		bvh->depth = 0;
+		a3bvhBuild_internal(bvh, 0, bvh->primCount, 0);
+		return bvh->nodeCount;
+	}
+	return -1;
+}
+
+// refit
+extern inline int a3bvhRefit(a3_BVH *bvh)
+{
+	if (bvh && bvh->node && bvh->nodeCount)
+	{
+		// children always come after parents, so walk backwards
+		a3_BVHNode *node = bvh->node + bvh->nodeCount;
+		const a3_BVHNode *child;
+		const float *b;
+		unsigned int i;
+		while (node-- > bvh->node)
+		{
+			a3bvhBoundsReset_internal(node->boundsMin, node->boundsMax);
+			if (node->count)
+			{
+				for (i = node->offset; i < node->offset + node->count; ++i)
+				{
+					b = bvh->primBounds + bvh->primIndex[i] * 6;
+					a3bvhBoundsGrow_internal(node->boundsMin, node->boundsMax, b, b + 3);
+				}
+			}
+			else
+			{
+				child = node + 1;
+				a3bvhBoundsGrow_internal(node->boundsMin, node->boundsMax, child->boundsMin, child->boundsMax);
+				child = bvh->node + node->offset;
+				a3bvhBoundsGrow_internal(node->boundsMin, node->boundsMax, child->boundsMin, child->boundsMax);
+			}
+		}
+		return bvh->nodeCount;
+	}
+	return -1;
+}
+
+// ray cast
+extern inline int a3bvhRayCast(p3real *param_out, int *index_out, const a3_BVH *bvh, const a3_Ray *ray, a3_BVHPrimitiveTest test_opt, const void *data_opt)
+{
+	if (param_out && index_out && bvh && bvh->node && bvh->nodeCount && ray)
+	{
+		const float origin[3] = { ray->origin.x, ray->origin.y, ray->origin.z };
+		const float dirInv[3] = { a3bvhDirInv_internal(ray->direction.x), a3bvhDirInv_internal(ray->direction.y), a3bvhDirInv_internal(ray->direction.z) };
+		unsigned int stack[a3bvh_stackSize], stackSize = 0, i, prim;
+		const a3_BVHNode *node, *child0, *child1;
+		float best = (float)HUGE_VAL, t0, t1;
+		p3real param;
+		int bestIndex = -1;
+
+		*index_out = -1;
+		if (a3bvhRayBox_internal(bvh->node->boundsMin, bvh->node->boundsMax, origin, dirInv, best) < 0.0f)
+			return 0;
+		stack[stackSize++] = 0;
+		while (stackSize)
+		{
+			node = bvh->node + stack[--stackSize];
+			if (node->count)
+			{
+				for (i = node->offset; i < node->offset + node->count; ++i)
+				{
+					prim = bvh->primIndex[i];
+					if (test_opt)
+					{
+						if (test_opt(&param, ray, prim, data_opt) && param < best)
+						{
+							best = param;
+							bestIndex = prim;
+						}
+					}
+					else
+					{
+						t0 = a3bvhRayBox_internal(bvh->primBounds + prim * 6, bvh->primBounds + prim * 6 + 3, origin, dirInv, best);
+						if (t0 >= 0.0f && t0 < best)
+						{
+							best = t0;
+							bestIndex = prim;
+						}
+					}
+				}
+			}
+			else
+			{
+				// visit nearer child first, skip children beyond best hit
+				child0 = node + 1;
+				child1 = bvh->node + node->offset;
+				t0 = a3bvhRayBox_internal(child0->boundsMin, child0->boundsMax, origin, dirInv, best);
+				t1 = a3bvhRayBox_internal(child1->boundsMin, child1->boundsMax, origin, dirInv, best);
+				if (t0 >= 0.0f && t1 >= 0.0f)
+				{
+					if (t0 <= t1)
+					{
+						stack[stackSize++] = node->offset;
+						stack[stackSize++] = (unsigned int)(child0 - bvh->node);
+					}
+					else
+					{
+						stack[stackSize++] = (unsigned int)(child0 - bvh->node);
+						stack[stackSize++] = node->offset;
+					}
+				}
+				else if (t0 >= 0.0f)
+					stack[stackSize++] = (unsigned int)(child0 - bvh->node);
+				else if (t1 >= 0.0f)
+					stack[stackSize++] = node->offset;
+			}
+		}
+
+		if (bestIndex >= 0)
+		{
+			*param_out = best;
+			*index_out = bestIndex;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// batch ray cast
+extern inline int a3bvhRayCastBatch(p3real *param_out, int *index_out, const a3_BVH *bvh, const a3_Ray *rays, const unsigned int rayCount, a3_BVHPrimitiveTest test_opt, const void *data_opt)
+{
+	if (param_out && index_out && bvh && rays)
+	{
+		unsigned int i;
+		int result = 0;
+		for (i = 0; i < rayCount; ++i)
+			result += a3bvhRayCast(param_out + i, index_out + i, bvh, rays + i, test_opt, data_opt);
+		return result;
+	}
+	return 0;
+}
+
+// sphere set primitive test
+int a3bvhTestSphereSet(p3real *param_out, const a3_Ray *ray, const unsigned int primIndex, const void *sphereSet)
+{
+	const a3_SphereSet *set = (const a3_SphereSet *)sphereSet;
+	a3_Sphere sphere[1];
+	a3_RayHit hit[1];
+	if (set && primIndex < set->count && set->radiusSq[primIndex] >= 0.0f)
+	{
+		sphere->center.x = set->centerX[primIndex];
+		sphere->center.y = set->centerY[primIndex];
+		sphere->center.z = set->centerZ[primIndex];
+		sphere->center.w = realOne;
+		sphere->radius = (p3real)sqrt(set->radiusSq[primIndex]);
+		if (a3rayTestSphere(hit, ray, sphere))
+		{
+			*param_out = hit->param0;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,127 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_RayPickingBVH.h
+	Bounding volume hierarchy for ray picking: built with the surface area 
+		heuristic, stored flat in depth-first order, refit in place when 
+		primitives move (e.g. joints from object space each frame).
+*/
+
+#ifndef __ANIMAL3D_RAYPICKINGBVH_H
+#define __ANIMAL3D_RAYPICKINGBVH_H
+
+
+#include "a3_RayPicking.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_BVHNode	a3_BVHNode;
+	typedef struct a3_BVH		a3_BVH;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// exact test for a single primitive, called for primitives in leaves 
+	//	whose box the ray enters; return 1 and set param if hit
+	//	(data is whatever was passed to the cast, e.g. a sphere set, or 
+	//	another BVH for two-level scene/skeleton picking)
+	typedef int(*a3_BVHPrimitiveTest)(p3real *param_out, const a3_Ray *ray, const unsigned int primIndex, const void *data);
+
+
+	// flattened node: 32 bytes; first child of an inner node is the next 
+	//	node, second child is at offset
+	struct a3_BVHNode
+	{
+		float boundsMin[3];
+		unsigned int offset;	// leaf: first primitive slot; inner: second child
+		float boundsMax[3];
+		unsigned int count;		// leaf: primitive count; inner: zero
+	};
+
+	// hierarchy
+	struct a3_BVH
+	{
+		// nodes in depth-first order
+		a3_BVHNode *node;
+		unsigned int nodeCount;
+
+		// deepest leaf of last build (capped: deeper subtrees become leaves)
+		unsigned int depth;
+
+		// primitive indices referenced by leaves
+		unsigned int *primIndex;
+
+		// primitive bounds: min xyz, max xyz per primitive
+		float *primBounds;
+		unsigned int primCount;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create hierarchy for a fixed number of primitives
+	inline int a3bvhCreate(a3_BVH *bvh_out, const unsigned int primCount);
+
+	// release hierarchy
+	inline int a3bvhRelease(a3_BVH *bvh);
+
+	// set bounds of a single primitive
+	inline int a3bvhSetPrimitiveBounds(a3_BVH *bvh, const unsigned int primIndex, const p3vec3 *boundsMin, const p3vec3 *boundsMax);
+
+	// set bounds of all primitives to cubes around each transform's 
+	//	translation (e.g. joints in object space, scene object positions)
+	inline int a3bvhSetBoundsFromTransforms(a3_BVH *bvh, const p3mat4 *transforms, const p3real radius);
+
+	// build tree from current primitive bounds (binned SAH)
+	//	return: number of nodes, -1 if invalid params
+	inline int a3bvhBuild(a3_BVH *bvh);
+
+	// refit tree to current primitive bounds without changing topology; 
+	//	much cheaper than a build, quality degrades as things move apart
+	inline int a3bvhRefit(a3_BVH *bvh);
+
+	// find nearest primitive hit by ray; if test is null the primitive 
+	//	boxes themselves are hit
+	//	return: 1 if hit (param and index set), 0 if no hit
+	inline int a3bvhRayCast(p3real *param_out, int *index_out, const a3_BVH *bvh, const a3_Ray *ray, a3_BVHPrimitiveTest test_opt, const void *data_opt);
+
+	// cast many rays; index is -1 for each miss
+	//	return: number of rays that hit
+	inline int a3bvhRayCastBatch(p3real *param_out, int *index_out, const a3_BVH *bvh, const a3_Ray *rays, const unsigned int rayCount, a3_BVHPrimitiveTest test_opt, const void *data_opt);
+
+	// primitive test against spheres in a sphere set (data is the set)
+	int a3bvhTestSphereSet(p3real *param_out, const a3_Ray *ray, const unsigned int primIndex, const void *sphereSet);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_RAYPICKINGBVH_H
@@ -0,0 +1,653 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Skinning.c
+	Implementation of CPU skinning.
+*/
+
+#include "a3_Skinning.h"
+
+#include <math.h>
+#include <string.h>
+
+#if (defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1) || defined __SSE__)
+#define A3_SKINNING_SSE
+#include <xmmintrin.h>
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+
+inline void a3skinningNormalize_internal(float *v)
+{
+	const float lenSq = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+	if (lenSq > 0.0f)
+	{
+		const float lenInv = 1.0f / sqrtf(lenSq);
+		v[0] *= lenInv;
+		v[1] *= lenInv;
+		v[2] *= lenInv;
+	}
+}
+
+#ifdef A3_SKINNING_SSE
+
+// blend palette columns by weights, then transform point and normal
+inline void a3skinningLinearBlendVertex_internal(float *position_out, float *normal_out, const float *position, const float *normal, const float *weights, const int *indices, const p3mat4 *palette)
+{
+	__m128 c0 = _mm_setzero_ps(), c1 = c0, c2 = c0, c3 = c0, w, r;
+	const float *m;
+	float tmp[4];
+	unsigned int i;
+
+	for (i = 0; i < a3skinningInfluenceMax; ++i)
+	{
+		if (weights[i] != 0.0f)
+		{
+			m = palette[indices[i]].mm;
+			w = _mm_set1_ps(weights[i]);
+			c0 = _mm_add_ps(c0, _mm_mul_ps(w, _mm_loadu_ps(m + 0)));
+			c1 = _mm_add_ps(c1, _mm_mul_ps(w, _mm_loadu_ps(m + 4)));
+			c2 = _mm_add_ps(c2, _mm_mul_ps(w, _mm_loadu_ps(m + 8)));
+			c3 = _mm_add_ps(c3, _mm_mul_ps(w, _mm_loadu_ps(m + 12)));
+		}
+	}
+
+	r = _mm_add_ps(_mm_add_ps(
+		_mm_mul_ps(c0, _mm_set1_ps(position[0])),
+		_mm_mul_ps(c1, _mm_set1_ps(position[1]))), _mm_add_ps(
+		_mm_mul_ps(c2, _mm_set1_ps(position[2])), c3));
+	_mm_storeu_ps(tmp, r);
+	position_out[0] = tmp[0];
+	position_out[1] = tmp[1];
+	position_out[2] = tmp[2];
+
+	if (normal_out)
+	{
+		r = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(c0, _mm_set1_ps(normal[0])),
+			_mm_mul_ps(c1, _mm_set1_ps(normal[1]))),
+			_mm_mul_ps(c2, _mm_set1_ps(normal[2])));
+		_mm_storeu_ps(tmp, r);
+		normal_out[0] = tmp[0];
+		normal_out[1] = tmp[1];
+		normal_out[2] = tmp[2];
+		a3skinningNormalize_internal(normal_out);
+	}
+}
+
+#else	// !A3_SKINNING_SSE
+
+inline void a3skinningLinearBlendVertex_internal(float *position_out, float *normal_out, const float *position, const float *normal, const float *weights, const int *indices, const p3mat4 *palette)
+{
+	float c[16] = { 0.0f };
+	const float *m;
+	unsigned int i, j;
+
+	for (i = 0; i < a3skinningInfluenceMax; ++i)
+	{
+		if (weights[i] != 0.0f)
+		{
+			m = palette[indices[i]].mm;
+			for (j = 0; j < 16; ++j)
+				c[j] += weights[i] * m[j];
+		}
+	}
+
+	position_out[0] = c[0] * position[0] + c[4] * position[1] + c[8] * position[2] + c[12];
+	position_out[1] = c[1] * position[0] + c[5] * position[1] + c[9] * position[2] + c[13];
+	position_out[2] = c[2] * position[0] + c[6] * position[1] + c[10] * position[2] + c[14];
+
+	if (normal_out)
+	{
+		normal_out[0] = c[0] * normal[0] + c[4] * normal[1] + c[8] * normal[2];
+		normal_out[1] = c[1] * normal[0] + c[5] * normal[1] + c[9] * normal[2];
+		normal_out[2] = c[2] * normal[0] + c[6] * normal[1] + c[10] * normal[2];
+		a3skinningNormalize_internal(normal_out);
+	}
+}
+
+#endif	// A3_SKINNING_SSE
+
+inline void a3skinningLinearBlend_internal(float *position_out, float *normal_out, const float *position, const float *normal, const float *blendWeights, const int *blendIndices, const p3mat4 *palette, const unsigned int firstVertex, const unsigned int vertexCount)
+{
+	const unsigned int end = firstVertex + vertexCount;
+	unsigned int i, i3, i4;
+	if (normal_out && normal)
+	{
+		for (i = firstVertex, i3 = i * 3, i4 = i * 4; i < end; ++i, i3 += 3, i4 += 4)
+			a3skinningLinearBlendVertex_internal(position_out + i3, normal_out + i3, position + i3, normal + i3, 
+				blendWeights + i4, blendIndices + i4, palette);
+	}
+	else
+	{
+		for (i = firstVertex, i3 = i * 3, i4 = i * 4; i < end; ++i, i3 += 3, i4 += 4)
+			a3skinningLinearBlendVertex_internal(position_out + i3, 0, position + i3, 0, 
+				blendWeights + i4, blendIndices + i4, palette);
+	}
+}
+
+
+// rotation quaternion from rigid matrix (Shepperd's method)
+//	column-major: element (row r, column c) is mm[c * 4 + r]
+inline void a3skinningQuatFromMatrix_internal(float *q_out, const float *mm)
+{
+	const float tr = mm[0] + mm[5] + mm[10];
+	float s;
+	if (tr > 0.0f)
+	{
+		s = 0.5f / sqrtf(tr + 1.0f);
+		q_out[3] = 0.25f / s;
+		q_out[0] = (mm[6] - mm[9]) * s;
+		q_out[1] = (mm[8] - mm[2]) * s;
+		q_out[2] = (mm[1] - mm[4]) * s;
+	}
+	else if (mm[0] > mm[5] && mm[0] > mm[10])
+	{
+		s = 2.0f * sqrtf(1.0f + mm[0] - mm[5] - mm[10]);
+		q_out[3] = (mm[6] - mm[9]) / s;
+		q_out[0] = 0.25f * s;
+		q_out[1] = (mm[4] + mm[1]) / s;
+		q_out[2] = (mm[8] + mm[2]) / s;
+	}
+	else if (mm[5] > mm[10])
+	{
+		s = 2.0f * sqrtf(1.0f + mm[5] - mm[0] - mm[10]);
+		q_out[3] = (mm[8] - mm[2]) / s;
+		q_out[0] = (mm[4] + mm[1]) / s;
+		q_out[1] = 0.25f * s;
+		q_out[2] = (mm[9] + mm[6]) / s;
+	}
+	else
+	{
+		s = 2.0f * sqrtf(1.0f + mm[10] - mm[0] - mm[5]);
+		q_out[3] = (mm[1] - mm[4]) / s;
+		q_out[0] = (mm[8] + mm[2]) / s;
+		q_out[1] = (mm[9] + mm[6]) / s;
+		q_out[2] = 0.25f * s;
+	}
+}
+
+// dual part: half of pure translation quaternion times rotation
+inline void a3skinningDualFromQuatTranslation_internal(float *d_out, const float *q, const float *t)
+{
+	d_out[0] = 0.5f * (+t[0] * q[3] + t[1] * q[2] - t[2] * q[1]);
+	d_out[1] = 0.5f * (-t[0] * q[2] + t[1] * q[3] + t[2] * q[0]);
+	d_out[2] = 0.5f * (+t[0] * q[1] - t[1] * q[0] + t[2] * q[3]);
+	d_out[3] = -0.5f * (t[0] * q[0] + t[1] * q[1] + t[2] * q[2]);
+}
+
+inline void a3skinningDualQuatFromMatrix_internal(a3_SkinningDualQuat *dq_out, const p3mat4 *mat)
+{
+	a3skinningQuatFromMatrix_internal(dq_out->real.v, mat->mm);
+	a3skinningDualFromQuatTranslation_internal(dq_out->dual.v, dq_out->real.v, mat->mm + 12);
+}
+
+inline void a3skinningCross_internal(float *v_out, const float *a, const float *b)
+{
+	v_out[0] = a[1] * b[2] - a[2] * b[1];
+	v_out[1] = a[2] * b[0] - a[0] * b[2];
+	v_out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+// heaviest influence; the blend hemisphere is chosen relative to it 
+//	so unsorted or zero-weight slots cannot pick an unrelated bone
+inline unsigned int a3skinningInfluenceHeaviest_internal(const float *weights)
+{
+	unsigned int i, heaviest = 0;
+	for (i = 1; i < a3skinningInfluenceMax; ++i)
+		if (weights[i] > weights[heaviest])
+			heaviest = i;
+	return heaviest;
+}
+
+// blend dual quaternions, then transform point and normal
+inline void a3skinningDualQuatVertex_internal(float *position_out, float *normal_out, const float *position, const float *normal, const float *weights, const int *indices, const a3_SkinningDualQuat *paletteDQ)
+{
+	const float *q0 = paletteDQ[indices[a3skinningInfluenceHeaviest_internal(weights)]].real.v;
+	const a3_SkinningDualQuat *dq;
+	float r[4], d[4], w, lenInv, a[3], b[3];
+	unsigned int i;
+
+#ifdef A3_SKINNING_SSE
+	__m128 rs = _mm_setzero_ps(), ds = rs, ws;
+	for (i = 0; i < a3skinningInfluenceMax; ++i)
+	{
+		if (weights[i] != 0.0f)
+		{
+			// keep all rotations in the heaviest one's hemisphere
+			dq = paletteDQ + indices[i];
+			w = (q0[0] * dq->real.x + q0[1] * dq->real.y + q0[2] * dq->real.z + q0[3] * dq->real.w) < 0.0f ? -weights[i] : weights[i];
+			ws = _mm_set1_ps(w);
+			rs = _mm_add_ps(rs, _mm_mul_ps(ws, _mm_loadu_ps(dq->real.v)));
+			ds = _mm_add_ps(ds, _mm_mul_ps(ws, _mm_loadu_ps(dq->dual.v)));
+		}
+	}
+	_mm_storeu_ps(r, rs);
+	_mm_storeu_ps(d, ds);
+#else	// !A3_SKINNING_SSE
+	r[0] = r[1] = r[2] = r[3] = d[0] = d[1] = d[2] = d[3] = 0.0f;
+	for (i = 0; i < a3skinningInfluenceMax; ++i)
+	{
+		if (weights[i] != 0.0f)
+		{
+			dq = paletteDQ + indices[i];
+			w = (q0[0] * dq->real.x + q0[1] * dq->real.y + q0[2] * dq->real.z + q0[3] * dq->real.w) < 0.0f ? -weights[i] : weights[i];
+			r[0] += w * dq->real.x;	r[1] += w * dq->real.y;	r[2] += w * dq->real.z;	r[3] += w * dq->real.w;
+			d[0] += w * dq->dual.x;	d[1] += w * dq->dual.y;	d[2] += w * dq->dual.z;	d[3] += w * dq->dual.w;
+		}
+	}
+#endif	// A3_SKINNING_SSE
+
+	// normalize by real part
+	lenInv = 1.0f / sqrtf(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+	for (i = 0; i < 4; ++i)
+	{
+		r[i] *= lenInv;
+		d[i] *= lenInv;
+	}
+
+	// rotate: v + 2 r x (r x v + w v)
+	a3skinningCross_internal(a, r, position);
+	a[0] += r[3] * position[0];	a[1] += r[3] * position[1];	a[2] += r[3] * position[2];
+	a3skinningCross_internal(b, r, a);
+
+	// translate: 2 (w d - dw r + r x d)
+	a3skinningCross_internal(a, r, d);
+	position_out[0] = position[0] + 2.0f * (b[0] + r[3] * d[0] - d[3] * r[0] + a[0]);
+	position_out[1] = position[1] + 2.0f * (b[1] + r[3] * d[1] - d[3] * r[1] + a[1]);
+	position_out[2] = position[2] + 2.0f * (b[2] + r[3] * d[2] - d[3] * r[2] + a[2]);
+
+	if (normal_out)
+	{
+		a3skinningCross_internal(a, r, normal);
+		a[0] += r[3] * normal[0];	a[1] += r[3] * normal[1];	a[2] += r[3] * normal[2];
+		a3skinningCross_internal(b, r, a);
+		normal_out[0] = normal[0] + 2.0f * b[0];
+		normal_out[1] = normal[1] + 2.0f * b[1];
+		normal_out[2] = normal[2] + 2.0f * b[2];
+	}
+}
+
+inline void a3skinningDualQuat_internal(float *position_out, float *normal_out, const float *position, const float *normal, const float *blendWeights, const int *blendIndices, const a3_SkinningDualQuat *paletteDQ, const unsigned int firstVertex, const unsigned int vertexCount)
+{
+	const unsigned int end = firstVertex + vertexCount;
+	unsigned int i, i3, i4;
+	if (normal_out && normal)
+	{
+		for (i = firstVertex, i3 = i * 3, i4 = i * 4; i < end; ++i, i3 += 3, i4 += 4)
+			a3skinningDualQuatVertex_internal(position_out + i3, normal_out + i3, position + i3, normal + i3, 
+				blendWeights + i4, blendIndices + i4, paletteDQ);
+	}
+	else
+	{
+		for (i = firstVertex, i3 = i * 3, i4 = i * 4; i < end; ++i, i3 += 3, i4 += 4)
+			a3skinningDualQuatVertex_internal(position_out + i3, 0, position + i3, 0, 
+				blendWeights + i4, blendIndices + i4, paletteDQ);
+	}
+}
+
+inline int a3skinningJobInit_internal(a3_SkinningJob *jobs_out, const unsigned int jobCount, float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const p3mat4 *palette, const a3_SkinningDualQuat *paletteDQ)
+{
+	const float *blendWeights;
+	const int *blendIndices;
+	if (jobs_out && jobCount && position_out && geom && (palette || paletteDQ) && 
+		geom->attribData[a3attrib_geomPosition] && 
+		a3skinningGetGeometryBlending(&blendWeights, &blendIndices, geom) > 0)
+	{
+		const float *normal = normal_out_opt ? (const float *)geom->attribData[a3attrib_geomNormal] : 0;
+		const unsigned int chunk = (geom->numVertices + jobCount - 1) / jobCount;
+		unsigned int i, first;
+		for (i = first = 0; i < jobCount; ++i, first += chunk)
+		{
+			jobs_out[i].position_out = position_out;
+			jobs_out[i].normal_out = normal ? normal_out_opt : 0;
+			jobs_out[i].position = (const float *)geom->attribData[a3attrib_geomPosition];
+			jobs_out[i].normal = normal;
+			jobs_out[i].blendWeights = blendWeights;
+			jobs_out[i].blendIndices = blendIndices;
+			jobs_out[i].palette = palette;
+			jobs_out[i].paletteDQ = paletteDQ;
+			jobs_out[i].firstVertex = minimum(first, geom->numVertices);
+			jobs_out[i].vertexCount = minimum(chunk, geom->numVertices - jobs_out[i].firstVertex);
+		}
+		return jobCount;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern inline int a3skinningBindPoseInverse(p3mat4 *bindPoseInverse_out, const a3_HierarchyTransform *bindObjectSpace, const unsigned int nodeCount)
+{
+	if (bindPoseInverse_out && bindObjectSpace && bindObjectSpace->transform)
+	{
+		unsigned int i;
+		for (i = 0; i < nodeCount; ++i)
+			p3real4x4TransformInverseIgnoreScale(bindPoseInverse_out[i].m, bindObjectSpace->transform[i].m);
+		return nodeCount;
+	}
+	return -1;
+}
+
+extern inline int a3skinningBuildPalette(p3mat4 *palette_out, const a3_HierarchyTransform *objectSpace, const p3mat4 *bindPoseInverse, const unsigned int nodeCount)
+{
+	if (palette_out && objectSpace && objectSpace->transform && bindPoseInverse)
+	{
+		unsigned int i;
+		for (i = 0; i < nodeCount; ++i)
+			p3real4x4Product(palette_out[i].m, objectSpace->transform[i].m, bindPoseInverse[i].m);
+		return nodeCount;
+	}
+	return -1;
+}
+
+extern inline int a3skinningPackedStride(const unsigned int nodeCount, const unsigned int alignment)
+{
+	if (nodeCount && alignment)
+	{
+		// stride must be a multiple of the smallest bone count whose size 
+		//	is a multiple of the alignment: lcm(size, alignment) / size
+		unsigned int a = sizeof(a3_SkinningPacked), b = alignment, t, unit;
+		while (b)
+		{
+			t = a % b;
+			a = b;
+			b = t;
+		}
+		unit = alignment / a;
+		return ((nodeCount + unit - 1) / unit * unit);
+	}
+	return -1;
+}
+
+extern inline int a3skinningBuildPalettePacked(a3_SkinningPacked *palette_out, const a3_HierarchyTransform *objectSpaceList, const unsigned int characterCount, const p3mat4 *bindPoseInverse, const unsigned int nodeCount, const unsigned int stride)
+{
+	if (palette_out && objectSpaceList && bindPoseInverse && stride >= nodeCount)
+	{
+		const p3mat4 *obj, *inv;
+		a3_SkinningPacked *out;
+		unsigned int c, i;
+
+#ifdef A3_SKINNING_SSE
+		__m128 o0, o1, o2, o3, p0, p1, p2, p3;
+#else	// !A3_SKINNING_SSE
+		p3mat4 p;
+#endif	// A3_SKINNING_SSE
+
+		for (c = 0; c < characterCount; ++c)
+		{
+			if (!objectSpaceList[c].transform)
+				return -1;
+			obj = objectSpaceList[c].transform;
+			inv = bindPoseInverse;
+			out = palette_out + c * stride;
+			for (i = 0; i < nodeCount; ++i, ++obj, ++inv, ++out)
+			{
+#ifdef A3_SKINNING_SSE
+				// product columns are object columns weighted by inverse bind
+				//	columns, then transpose to get rows
+				o0 = _mm_loadu_ps(obj->mm + 0);
+				o1 = _mm_loadu_ps(obj->mm + 4);
+				o2 = _mm_loadu_ps(obj->mm + 8);
+				o3 = _mm_loadu_ps(obj->mm + 12);
+#define a3skinningColumn_internal(j)	_mm_add_ps(\
+	_mm_add_ps(_mm_mul_ps(o0, _mm_set1_ps(inv->m[j][0])), _mm_mul_ps(o1, _mm_set1_ps(inv->m[j][1]))),\
+	_mm_add_ps(_mm_mul_ps(o2, _mm_set1_ps(inv->m[j][2])), _mm_mul_ps(o3, _mm_set1_ps(inv->m[j][3]))))
+				p0 = a3skinningColumn_internal(0);
+				p1 = a3skinningColumn_internal(1);
+				p2 = a3skinningColumn_internal(2);
+				p3 = a3skinningColumn_internal(3);
+#undef a3skinningColumn_internal
+				_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+				_mm_storeu_ps(out->row0.v, p0);
+				_mm_storeu_ps(out->row1.v, p1);
+				_mm_storeu_ps(out->row2.v, p2);
+#else	// !A3_SKINNING_SSE
+				p3real4x4Product(p.m, obj->m, inv->m);
+				out->row0.x = p.m00;	out->row0.y = p.m10;	out->row0.z = p.m20;	out->row0.w = p.m30;
+				out->row1.x = p.m01;	out->row1.y = p.m11;	out->row1.z = p.m21;	out->row1.w = p.m31;
+				out->row2.x = p.m02;	out->row2.y = p.m12;	out->row2.z = p.m22;	out->row2.w = p.m32;
+#endif	// A3_SKINNING_SSE
+			}
+		}
+		return (characterCount * stride * sizeof(a3_SkinningPacked));
+	}
+	return -1;
+}
+
+extern inline int a3skinningGetGeometryBlending(const float **blendWeights_out, const int **blendIndices_out, const a3_GeometryData *geom)
+{
+	if (blendWeights_out && blendIndices_out && geom)
+	{
+		const float *weights = (const float *)geom->attribData[a3attrib_geomBlending];
+		if (weights)
+		{
+			*blendWeights_out = weights;
+			*blendIndices_out = (const int *)(weights + geom->numVertices * a3skinningInfluenceMax);
+			return 1;
+		}
+		*blendWeights_out = 0;
+		*blendIndices_out = 0;
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern inline int a3skinningLinearBlend(float *position_out, float *normal_out_opt, const float *position, const float *normal_opt, const float *blendWeights, const int *blendIndices, const p3mat4 *palette, const unsigned int firstVertex, const unsigned int vertexCount)
+{
+	if (position_out && position && blendWeights && blendIndices && palette)
+	{
+		a3skinningLinearBlend_internal(position_out, normal_out_opt, position, normal_opt, 
+			blendWeights, blendIndices, palette, firstVertex, vertexCount);
+		return vertexCount;
+	}
+	return -1;
+}
+
+extern inline int a3skinningLinearBlendGeometry(float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const p3mat4 *palette)
+{
+	a3_SkinningJob job[1];
+	if (a3skinningJobInit(job, 1, position_out, normal_out_opt, geom, palette) > 0)
+		return a3skinningJobRun(job);
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern inline int a3skinningDualQuatSet(a3_SkinningDualQuat *dq_out, const p3vec4 *rotation, const p3vec4 *translation)
+{
+	if (dq_out && rotation && translation)
+	{
+		dq_out->real = *rotation;
+		a3skinningDualFromQuatTranslation_internal(dq_out->dual.v, rotation->v, translation->v);
+		return 1;
+	}
+	return -1;
+}
+
+extern inline int a3skinningDualQuatFromMatrices(a3_SkinningDualQuat *dq_out, const p3mat4 *mat, const unsigned int count)
+{
+	if (dq_out && mat)
+	{
+		unsigned int i = 0;
+
+#ifdef A3_SKINNING_SSE
+		// four at a time in SoA form using the trace branch of Shepperd's 
+		//	method; lanes with a small real part, where that branch loses 
+		//	precision, are redone with the full scalar method
+		const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), half = _mm_set1_ps(0.5f);
+		const __m128 quarter = _mm_set1_ps(0.25f), minW = _mm_set1_ps(0.25f);
+		__m128 qx, qy, qz, qw, tx, ty, tz, dx, dy, dz, dw, s, lenInv;
+		unsigned int k;
+		int redo;
+
+#define a3skinningGather_internal(e)	_mm_set_ps(mat[i + 3].mm[e], mat[i + 2].mm[e], mat[i + 1].mm[e], mat[i + 0].mm[e])
+#define a3skinningDiff_internal(e0, e1)	_mm_sub_ps(a3skinningGather_internal(e0), a3skinningGather_internal(e1))
+
+		for (; i + 4 <= count; i += 4)
+		{
+			qw = _mm_mul_ps(half, _mm_sqrt_ps(_mm_max_ps(zero, _mm_add_ps(_mm_add_ps(one, a3skinningGather_internal(0)), 
+				_mm_add_ps(a3skinningGather_internal(5), a3skinningGather_internal(10))))));
+			redo = _mm_movemask_ps(_mm_cmplt_ps(qw, minW));
+			s = _mm_div_ps(quarter, _mm_max_ps(qw, minW));
+			qx = _mm_mul_ps(s, a3skinningDiff_internal(6, 9));
+			qy = _mm_mul_ps(s, a3skinningDiff_internal(8, 2));
+			qz = _mm_mul_ps(s, a3skinningDiff_internal(1, 4));
+
+			lenInv = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)), 
+				_mm_add_ps(_mm_mul_ps(qz, qz), _mm_mul_ps(qw, qw)))));
+			qx = _mm_mul_ps(qx, lenInv);
+			qy = _mm_mul_ps(qy, lenInv);
+			qz = _mm_mul_ps(qz, lenInv);
+			qw = _mm_mul_ps(qw, lenInv);
+
+			tx = _mm_mul_ps(half, a3skinningGather_internal(12));
+			ty = _mm_mul_ps(half, a3skinningGather_internal(13));
+			tz = _mm_mul_ps(half, a3skinningGather_internal(14));
+			dx = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(tx, qw), _mm_mul_ps(ty, qz)), _mm_mul_ps(tz, qy));
+			dy = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(ty, qw), _mm_mul_ps(tx, qz)), _mm_mul_ps(tz, qx));
+			dz = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(tx, qy), _mm_mul_ps(ty, qx)), _mm_mul_ps(tz, qw));
+			dw = _mm_sub_ps(zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, qx), _mm_mul_ps(ty, qy)), _mm_mul_ps(tz, qz)));
+
+			// back to one dual quaternion per lane
+			_MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+			_MM_TRANSPOSE4_PS(dx, dy, dz, dw);
+			_mm_storeu_ps(dq_out[i + 0].real.v, qx);
+			_mm_storeu_ps(dq_out[i + 1].real.v, qy);
+			_mm_storeu_ps(dq_out[i + 2].real.v, qz);
+			_mm_storeu_ps(dq_out[i + 3].real.v, qw);
+			_mm_storeu_ps(dq_out[i + 0].dual.v, dx);
+			_mm_storeu_ps(dq_out[i + 1].dual.v, dy);
+			_mm_storeu_ps(dq_out[i + 2].dual.v, dz);
+			_mm_storeu_ps(dq_out[i + 3].dual.v, dw);
+
+			for (k = 0; redo; ++k, redo >>= 1)
+				if (redo & 1)
+					a3skinningDualQuatFromMatrix_internal(dq_out + i + k, mat + i + k);
+		}
+
+#undef a3skinningDiff_internal
+#undef a3skinningGather_internal
+#endif	// A3_SKINNING_SSE
+
+		for (; i < count; ++i)
+			a3skinningDualQuatFromMatrix_internal(dq_out + i, mat + i);
+		return count;
+	}
+	return -1;
+}
+
+extern inline int a3skinningBuildPaletteDualQuat(a3_SkinningDualQuat *paletteDQ_out, p3mat4 *palette_tmp, const a3_HierarchyTransform *objectSpace, const p3mat4 *bindPoseInverse, const unsigned int nodeCount)
+{
+	if (paletteDQ_out && a3skinningBuildPalette(palette_tmp, objectSpace, bindPoseInverse, nodeCount) >= 0)
+		return a3skinningDualQuatFromMatrices(paletteDQ_out, palette_tmp, nodeCount);
+	return -1;
+}
+
+extern inline int a3skinningDualQuat(float *position_out, float *normal_out_opt, const float *position, const float *normal_opt, const float *blendWeights, const int *blendIndices, const a3_SkinningDualQuat *paletteDQ, const unsigned int firstVertex, const unsigned int vertexCount)
+{
+	if (position_out && position && blendWeights && blendIndices && paletteDQ)
+	{
+		a3skinningDualQuat_internal(position_out, normal_out_opt, position, normal_opt, 
+			blendWeights, blendIndices, paletteDQ, firstVertex, vertexCount);
+		return vertexCount;
+	}
+	return -1;
+}
+
+extern inline int a3skinningDualQuatGeometry(float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const a3_SkinningDualQuat *paletteDQ)
+{
+	a3_SkinningJob job[1];
+	if (a3skinningJobInitDualQuat(job, 1, position_out, normal_out_opt, geom, paletteDQ) > 0)
+		return a3skinningJobRun(job);
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern inline int a3skinningJobInit(a3_SkinningJob *jobs_out, const unsigned int jobCount, float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const p3mat4 *palette)
+{
+	if (palette)
+		return a3skinningJobInit_internal(jobs_out, jobCount, position_out, normal_out_opt, geom, palette, 0);
+	return -1;
+}
+
+extern inline int a3skinningJobInitDualQuat(a3_SkinningJob *jobs_out, const unsigned int jobCount, float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const a3_SkinningDualQuat *paletteDQ)
+{
+	if (paletteDQ)
+		return a3skinningJobInit_internal(jobs_out, jobCount, position_out, normal_out_opt, geom, 0, paletteDQ);
+	return -1;
+}
+
+long a3skinningJobRun(void *job)
+{
+	const a3_SkinningJob *j = (const a3_SkinningJob *)job;
+	if (j)
+	{
+		if (j->paletteDQ)
+			a3skinningDualQuat_internal(j->position_out, j->normal_out, j->position, j->normal, 
+				j->blendWeights, j->blendIndices, j->paletteDQ, j->firstVertex, j->vertexCount);
+		else
+			a3skinningLinearBlend_internal(j->position_out, j->normal_out, j->position, j->normal, 
+				j->blendWeights, j->blendIndices, j->palette, j->firstVertex, j->vertexCount);
+		return j->vertexCount;
+	}
+	return -1;
+}
+
+extern inline int a3skinningJobRunThreaded(a3_SkinningJob *jobs, a3_Thread *threads, const unsigned int jobCount)
+{
+	if (jobs && jobCount && (threads || jobCount == 1))
+	{
+		int result;
+		unsigned int i;
+
+		// hand out all but the first job, run the first one here; 
+		//	launch wants an unused descriptor, so clear any spent ones
+		result = 0;
+		for (i = 1; i < jobCount; ++i)
+		{
+			memset(threads + i - 1, 0, sizeof(a3_Thread));
+			if (a3threadLaunch(threads + i - 1, a3skinningJobRun, jobs + i, 0) <= 0)
+			{
+				// could not launch: run it here and leave nothing to wait for
+				memset(threads + i - 1, 0, sizeof(a3_Thread));
+				result += a3skinningJobRun(jobs + i);
+			}
+		}
+		result += a3skinningJobRun(jobs);
+		for (i = 1; i < jobCount; ++i)
+			if (threads[i - 1].threadFunc && a3threadWait(threads + i - 1) > 0)
+				result += threads[i - 1].result;
+		return result;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,188 @@
+/*
+	Copyright 2011-2017 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Skinning.h
+	CPU skinning of geometry with blend weights and indices (as loaded by 
+		a3modelLoadOBJSkinWeights). No graphics dependency, so this can also 
+		run headless (e.g. server-side hit detection, software rendering).
+*/
+
+#ifndef __ANIMAL3D_SKINNING_H
+#define __ANIMAL3D_SKINNING_H
+
+
+#include "a3_HierarchyState.h"
+
+#include "animal3D/a3graphics/a3geometry/a3_GeometryData.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_SkinningDualQuat	a3_SkinningDualQuat;
+	typedef struct a3_SkinningPacked	a3_SkinningPacked;
+	typedef struct a3_SkinningJob		a3_SkinningJob;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// maximum influences per vertex (matches vec4 weights and ivec4 indices)
+	enum a3_SkinningInfluenceMax
+	{
+		a3skinningInfluenceMax = 4
+	};
+
+
+	// unit dual quaternion: rigid transform in 8 values instead of 16
+	struct a3_SkinningDualQuat
+	{
+		// rotation quaternion (x, y, z, w)
+		p3vec4 real;
+
+		// half translation times rotation
+		p3vec4 dual;
+	};
+
+
+	// affine bone matrix packed as its first three rows (std140 layout is 
+	//	three vec4 per bone with no padding); in GLSL, transform with 
+	//	vec3(dot(row0, p), dot(row1, p), dot(row2, p)) for p = vec4(pos, 1)
+	struct a3_SkinningPacked
+	{
+		p3vec4 row0, row1, row2;
+	};
+
+
+	// description of a range of vertices to skin; can be handed to any 
+	//	thread as-is (see a3skinningJobRun)
+	struct a3_SkinningJob
+	{
+		// outputs: xyz per vertex; normals optional
+		float *position_out, *normal_out;
+
+		// inputs: xyz per vertex; normals optional
+		const float *position, *normal;
+
+		// inputs: 4 weights and 4 bone indices per vertex
+		const float *blendWeights;
+		const int *blendIndices;
+
+		// bone palette (object-space x inverse bind); only one of these is 
+		//	set, which selects linear blend or dual quaternion skinning
+		const p3mat4 *palette;
+		const a3_SkinningDualQuat *paletteDQ;
+
+		// vertex range
+		unsigned int firstVertex, vertexCount;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// compute inverse bind matrices from object-space bind pose
+	inline int a3skinningBindPoseInverse(p3mat4 *bindPoseInverse_out, const a3_HierarchyTransform *bindObjectSpace, const unsigned int nodeCount);
+
+	// build skinning palette: object-space x inverse bind
+	inline int a3skinningBuildPalette(p3mat4 *palette_out, const a3_HierarchyTransform *objectSpace, const p3mat4 *bindPoseInverse, const unsigned int nodeCount);
+
+	// number of bones to reserve per character in a packed palette so that 
+	//	each character starts on the given byte alignment (e.g. the uniform 
+	//	buffer offset alignment); pass 1 for tight packing
+	inline int a3skinningPackedStride(const unsigned int nodeCount, const unsigned int alignment);
+
+	// build packed palettes for a group of characters sharing a skeleton: 
+	//	character i's palette starts at bone (i * stride); the result can be 
+	//	uploaded as-is with a3bufferFill to an a3_UniformBuffer and ranges 
+	//	bound per character
+	//	return: number of bytes written, -1 if invalid params
+	inline int a3skinningBuildPalettePacked(a3_SkinningPacked *palette_out, const a3_HierarchyTransform *objectSpaceList, const unsigned int characterCount, const p3mat4 *bindPoseInverse, const unsigned int nodeCount, const unsigned int stride);
+
+	// get blend weights and indices from geometry; weights are assumed to 
+	//	be stored as one vec4 per vertex followed by one ivec4 per vertex
+	//	return: 1 if geometry has blending data, 0 if not, -1 if invalid
+	inline int a3skinningGetGeometryBlending(const float **blendWeights_out, const int **blendIndices_out, const a3_GeometryData *geom);
+
+
+//-----------------------------------------------------------------------------
+
+	// linear blend skinning of a range of vertices; positions and normals 
+	//	are tightly packed xyz; normal pointers may be null
+	//	return: number of vertices skinned, -1 if invalid params
+	inline int a3skinningLinearBlend(float *position_out, float *normal_out_opt, const float *position, const float *normal_opt, const float *blendWeights, const int *blendIndices, const p3mat4 *palette, const unsigned int firstVertex, const unsigned int vertexCount);
+
+	// linear blend skinning of all vertices in geometry; normals are 
+	//	skinned if requested and the geometry has them
+	inline int a3skinningLinearBlendGeometry(float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const p3mat4 *palette);
+
+
+//-----------------------------------------------------------------------------
+
+	// set dual quaternion from unit rotation quaternion and translation
+	inline int a3skinningDualQuatSet(a3_SkinningDualQuat *dq_out, const p3vec4 *rotation, const p3vec4 *translation);
+
+	// convert rigid matrices to dual quaternions (batched; scale ignored)
+	inline int a3skinningDualQuatFromMatrices(a3_SkinningDualQuat *dq_out, const p3mat4 *mat, const unsigned int count);
+
+	// build dual quaternion palette: object-space x inverse bind, converted
+	//	(palette_tmp receives the matrix palette along the way)
+	inline int a3skinningBuildPaletteDualQuat(a3_SkinningDualQuat *paletteDQ_out, p3mat4 *palette_tmp, const a3_HierarchyTransform *objectSpace, const p3mat4 *bindPoseInverse, const unsigned int nodeCount);
+
+	// dual quaternion skinning of a range of vertices; same layout rules as 
+	//	linear blend skinning
+	inline int a3skinningDualQuat(float *position_out, float *normal_out_opt, const float *position, const float *normal_opt, const float *blendWeights, const int *blendIndices, const a3_SkinningDualQuat *paletteDQ, const unsigned int firstVertex, const unsigned int vertexCount);
+
+	// dual quaternion skinning of all vertices in geometry
+	inline int a3skinningDualQuatGeometry(float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const a3_SkinningDualQuat *paletteDQ);
+
+
+//-----------------------------------------------------------------------------
+
+	// split vertices into equal jobs (job count is also the max thread count)
+	//	return: number of jobs initialized, -1 if invalid params
+	inline int a3skinningJobInit(a3_SkinningJob *jobs_out, const unsigned int jobCount, float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const p3mat4 *palette);
+
+	// same as above, but jobs use dual quaternion skinning
+	inline int a3skinningJobInitDualQuat(a3_SkinningJob *jobs_out, const unsigned int jobCount, float *position_out, float *normal_out_opt, const a3_GeometryData *geom, const a3_SkinningDualQuat *paletteDQ);
+
+	// run skinning job; has thread function signature so it 
+	//	can be passed straight to a3threadLaunch or a job system
+	long a3skinningJobRun(void *job);
+
+	// run jobs on threads and wait for them all; the first job runs on the 
+	//	calling thread, so threads needs (job count - 1) descriptors, which 
+	//	are reset on each call; jobs that fail to launch run on the caller
+	//	return: total number of vertices skinned, -1 if invalid params
+	inline int a3skinningJobRunThreaded(a3_SkinningJob *jobs, a3_Thread *threads, const unsigned int jobCount);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_SKINNING_H
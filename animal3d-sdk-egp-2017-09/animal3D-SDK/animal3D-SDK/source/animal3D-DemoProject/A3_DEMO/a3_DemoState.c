@@ -906,6 +906,10 @@ void a3demo_loadAnimation(a3_DemoState *demoState)
 	i = a3hierarchyGetNodeIndex(demoState->skeleton, "skel_elbow_l");
 	tmpPosePtr->nodePose[i].orientation.z = -30.0f;
 
+	// poses were authored as Euler angles; convert once to quaternions 
+	//	so that per-frame conversion to matrices needs no trig
+	a3hierarchyPoseGroupConvertEulerToQuat(demoState->skeletonPoses);
+
 
 	// setup clips
 	a3clipCreateGroup(demoState->skeletonClips, 4);
@@ -914,6 +918,11 @@ void a3demo_loadAnimation(a3_DemoState *demoState)
 	a3clipInit(demoState->skeletonClips, 2, "skel_wobble", 9, 10, 0.25f);
 	a3clipInit(demoState->skeletonClips, 3, "skel_crouch", 11, 11, 0.0f);
 
+	// idle and walk are only ever played as the full pose: bake the base 
+	//	pose into their keys once; wobble and crouch stay additive layers
+	a3clipBakeBasePose(demoState->skeletonClips, 0, demoState->skeletonPoses, 0, a3poseFlag_rotate_q | a3poseFlag_translate);
+	a3clipBakeBasePose(demoState->skeletonClips, 1, demoState->skeletonPoses, 0, a3poseFlag_rotate_q | a3poseFlag_translate);
+
 	a3clipCtrlSet(demoState->ctrlIdle, demoState->skeletonClips, 0);
 	a3clipCtrlSet(demoState->ctrlWalk, demoState->skeletonClips, 1);
 	a3clipCtrlSet(demoState->ctrlWobble, demoState->skeletonClips, 2);
@@ -931,15 +940,59 @@ void a3demo_loadAnimation(a3_DemoState *demoState)
 
 	// convert to local matrices
 	a3hierarchyPoseConvert(demoState->skeletonState_blend->localSpace, demoState->skeletonState_blend->localPose, 
-		demoState->skeleton->numNodes, a3poseFlag_translate | a3poseFlag_rotate);
+		demoState->skeleton->numNodes, a3poseFlag_translate | a3poseFlag_rotate_q);
 
 	// set base states
 	a3kinematicsSolveForward(demoState->skeletonState_blend);
 
+	// previous tick starts out the same as the current one
+	a3hierarchyStateCreate(demoState->skeletonState_prev, demoState->skeletonPoses);
+	a3hierarchyTransformCopy(demoState->skeletonState_prev->objectSpace, demoState->skeletonState_blend->objectSpace, demoState->skeleton->numNodes);
+
+	// evaluation cache: 64 entries, frame params quantized to 64 steps
+	a3poseCacheCreate(demoState->skeletonPoseCache, demoState->skeletonPoses, 64, 64);
+
+	// transitions between modes are inertialized from the base state
+	a3inertializerCreate(demoState->skeletonInertializer, demoState->skeleton);
+
+	// state machine: idle <-> walk <-> walk + crouch, driven by blend param
+	//	(param 0); crouch layer weight is param 1
+	a3animStateMachineCreate(demoState->skeletonStateMachine, demoState->skeletonClips, demoState->skeletonPoses, 0, 3, 4);
+	a3animStateInit(demoState->skeletonStateMachine, 0, "idle", a3animState_clip, 0, 0, 0, 1.0f);
+	a3animStateInit(demoState->skeletonStateMachine, 1, "walk", a3animState_clip, 1, 0, 0, 1.0f);
+	a3animStateInit(demoState->skeletonStateMachine, 2, "walk + crouch", a3animState_layer, 1, 3, 1, 1.0f);
+	a3animTransitionInit(demoState->skeletonStateMachine, 0, -1, 0, a3animCondition_less, 0, 0.25f, 0.0f, 0.4f, 0);
+	a3animTransitionInit(demoState->skeletonStateMachine, 1, 0, 1, a3animCondition_greater, 0, 0.33f, 0.0f, 0.3f, 0);
+	a3animTransitionInit(demoState->skeletonStateMachine, 2, 1, 2, a3animCondition_greater, 0, 0.66f, 0.0f, 0.2f, 1);
+	a3animTransitionInit(demoState->skeletonStateMachine, 3, 2, 1, a3animCondition_less, 0, 0.6f, 0.0f, 0.2f, 1);
+	a3animStatePlayerInit(demoState->skeletonStatePlayer, demoState->skeletonStateMachine, 0);
+	a3animStatePlayerSetParam(demoState->skeletonStatePlayer, 1, 0.75f);
+	a3hierarchyPosePoolCreate(demoState->skeletonPosePool, demoState->skeleton, 8);
+
+	// publish base state so render has something to acquire
+	//	(axes are drawn at a fifth of the joint size)
+	a3hierarchyStateBufferCreate(demoState->skeletonStateBuffer, demoState->skeletonPoses);
+	for (i = 0; i < 3; ++i)
+		a3boneDisplayCreate(demoState->skeletonDisplay + i, demoState->skeleton, 0.2f);
+	a3hierarchyTransformCopy(a3hierarchyStateBufferGetWrite(demoState->skeletonStateBuffer)->objectSpace, 
+		demoState->skeletonState_blend->objectSpace, demoState->skeleton->numNodes);
+	a3boneDisplayUpdate(demoState->skeletonDisplay + demoState->skeletonStateBuffer->writeIndex, 
+		a3hierarchyStateBufferGetWrite(demoState->skeletonStateBuffer)->objectSpace);
+	a3hierarchyStateBufferPublish(demoState->skeletonStateBuffer);
+	a3hierarchyStateBufferAcquire(demoState->skeletonStateBuffer);
+
 
 	// other settings
-	demoState->animationModeCount = 8;
+	demoState->animationModeCount = 9;
+	demoState->animationModePrev = demoState->animationMode;
+	demoState->transitionDuration = 0.3f;
 	demoState->targetBlendBetaSmoothing = 0.5f;
+
+	// fixed animation tick rate, independent of render rate
+	demoState->animationTickRate = 30.0;
+	demoState->animationTickDuration = 1.0 / demoState->animationTickRate;
+	demoState->animationTickTime = 0.0;
+	demoState->animationTickParam = 0.0f;
 }
 
 // unload animation
@@ -951,6 +1004,15 @@ void a3demo_unloadAnimation(a3_DemoState *demoState)
 
 	a3hierarchyPoseGroupRelease(demoState->skeletonPoses_blend);
 	a3hierarchyStateRelease(demoState->skeletonState_blend);
+	a3hierarchyStateRelease(demoState->skeletonState_prev);
+	a3poseCacheRelease(demoState->skeletonPoseCache);
+	a3inertializerRelease(demoState->skeletonInertializer);
+	a3animStateMachineRelease(demoState->skeletonStateMachine);
+	a3hierarchyPosePoolRelease(demoState->skeletonPosePool);
+	a3hierarchyStateBufferRelease(demoState->skeletonStateBuffer);
+	a3boneDisplayRelease(demoState->skeletonDisplay + 0);
+	a3boneDisplayRelease(demoState->skeletonDisplay + 1);
+	a3boneDisplayRelease(demoState->skeletonDisplay + 2);
 
 	a3clipReleaseGroup(demoState->skeletonClips);
 }
@@ -1199,26 +1261,55 @@ void a3demo_input(a3_DemoState *demoState, double dt)
 	}
 }
 
-void a3demo_update(a3_DemoState *demoState, double dt)
+// evaluate single clip through the shared cache and copy result to state
+inline void a3demo_evaluateClipCached(a3_DemoState *demoState, const a3_HierarchyState *state_out, const a3_ClipController *ctrl)
 {
-	unsigned int i;
+	const a3_HierarchyPoseGroup *poseSourceGroup = demoState->skeletonPoses;
+	const a3_HierarchyPoseGroup *poseBlendGroup = demoState->skeletonPoses_blend;
+	const unsigned int nodeCount = demoState->skeleton->numNodes;
+	const a3_Clip *clip = ctrl->clipGroup->clips + ctrl->clipIndex;
+	a3_HierarchyState *cachedState;
+	a3_PoseCacheKey key[1];
+
+	a3poseCacheMakeKey(key, demoState->skeletonPoseCache, ctrl, 0, 0.0f);
+	if (a3poseCacheAcquire(demoState->skeletonPoseCache, key, &cachedState) == 0)
+	{
+		// miss: evaluate at the quantized param so the entry can be shared
+		// absolute clips already contain the base pose
+		if (clip->poseMode == a3clipPose_absolute)
+			a3hierarchyPoseLERP(cachedState->localPose,
+				poseSourceGroup->pose + ctrl->frameIndex, poseSourceGroup->pose + ctrl->nextIndex, 
+				a3poseCacheKeyGetFrameParam(demoState->skeletonPoseCache, key),
+				nodeCount, a3poseFlag_rotate_q | a3poseFlag_translate);
+		else
+		{
+			a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
+				poseSourceGroup->pose + ctrl->frameIndex, poseSourceGroup->pose + ctrl->nextIndex, 
+				a3poseCacheKeyGetFrameParam(demoState->skeletonPoseCache, key),
+				nodeCount, a3poseFlag_rotate_q | a3poseFlag_translate);
+			a3hierarchyPoseConcat(cachedState->localPose,
+				poseSourceGroup->pose, poseBlendGroup->pose + 0,
+				nodeCount, a3poseFlag_rotate_q | a3poseFlag_translate);
+		}
+		a3hierarchyPoseConvert(cachedState->localSpace, cachedState->localPose,
+			nodeCount, a3poseFlag_rotate_q | a3poseFlag_translate);
+		a3kinematicsSolveForward(cachedState);
+	}
+
+	// this character has no root offset of its own
+	a3hierarchyPoseCopy(state_out->localPose, cachedState->localPose, nodeCount);
+	a3hierarchyTransformCopy(state_out->localSpace, cachedState->localSpace, nodeCount);
+	a3poseCacheApplyRootOffset(state_out->objectSpace, cachedState, 0);
+}
 
+// single fixed-rate animation tick: solve kinematics and do blending here
+inline void a3demo_updateAnimation(a3_DemoState *demoState, const float dt)
+{
 	const a3_HierarchyState *currentHierarchyState;
 	const a3_HierarchyPoseGroup *poseSourceGroup, *poseBlendGroup;
 	a3_ClipController *clipCtrl0, *clipCtrl1, *clipCtrl2;
 
 
-	// update scene objects
-	for (i = 0; i < demoStateMaxCount_sceneObject; ++i)
-		a3demo_updateSceneObject(demoState->sceneObject + i);
-
-	// update cameras
-	for (i = 0; i < demoStateMaxCount_camera; ++i)
-		a3demo_updateCameraViewProjection(demoState->camera + i);
-
-
-	// animation: solve kinematics and do blending here
-
 	// first update test interpolation param
 	demoState->targetBlendBeta = clamp(realZero, realOne, demoState->targetBlendBeta);
 	demoState->blendBeta = lerp(demoState->blendBeta, demoState->targetBlendBeta, demoState->targetBlendBetaSmoothing);
@@ -1236,24 +1327,10 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl0 = demoState->ctrlIdle;
 
 		// update clip
-		a3clipCtrlUpdate(clipCtrl0, (float)dt);
-
-		// yea yea
-		a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
-			poseSourceGroup->pose + clipCtrl0->frameIndex, poseSourceGroup->pose + clipCtrl0->nextIndex, clipCtrl0->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+		a3clipCtrlUpdate(clipCtrl0, dt);
 
-		// concat with base
-		a3hierarchyPoseConcat(currentHierarchyState->localPose,
-			poseSourceGroup->pose, poseBlendGroup->pose + 0,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// get matricies 
-		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// solve fk
-		a3kinematicsSolveForward(currentHierarchyState);
+		// shared evaluation
+		a3demo_evaluateClipCached(demoState, currentHierarchyState, clipCtrl0);
 
 		break;
 
@@ -1262,24 +1339,10 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl0 = demoState->ctrlWalk;
 
 		// update clip
-		a3clipCtrlUpdate(clipCtrl0, (float)dt);
+		a3clipCtrlUpdate(clipCtrl0, dt);
 
-		// yea yea
-		a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
-			poseSourceGroup->pose + clipCtrl0->frameIndex, poseSourceGroup->pose + clipCtrl0->nextIndex, clipCtrl0->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// concat with base
-		a3hierarchyPoseConcat(currentHierarchyState->localPose,
-			poseSourceGroup->pose, poseBlendGroup->pose + 0,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// get matricies 
-		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// solve fk
-		a3kinematicsSolveForward(currentHierarchyState);
+		// shared evaluation
+		a3demo_evaluateClipCached(demoState, currentHierarchyState, clipCtrl0);
 
 		break;
 
@@ -1288,24 +1351,10 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl0 = demoState->ctrlWobble;
 
 		// update clip
-		a3clipCtrlUpdate(clipCtrl0, (float)dt);
-
-		// yea yea
-		a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
-			poseSourceGroup->pose + clipCtrl0->frameIndex, poseSourceGroup->pose + clipCtrl0->nextIndex, clipCtrl0->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// concat with base
-		a3hierarchyPoseConcat(currentHierarchyState->localPose,
-			poseSourceGroup->pose, poseBlendGroup->pose + 0,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+		a3clipCtrlUpdate(clipCtrl0, dt);
 
-		// get matricies 
-		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// solve fk
-		a3kinematicsSolveForward(currentHierarchyState);
+		// shared evaluation
+		a3demo_evaluateClipCached(demoState, currentHierarchyState, clipCtrl0);
 
 		break;
 
@@ -1314,24 +1363,10 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl0 = demoState->ctrlCrouch;
 
 		// update clip
-		a3clipCtrlUpdate(clipCtrl0, (float)dt);
-
-		// yea yea
-		a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
-			poseSourceGroup->pose + clipCtrl0->frameIndex, poseSourceGroup->pose + clipCtrl0->nextIndex, clipCtrl0->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+		a3clipCtrlUpdate(clipCtrl0, dt);
 
-		// concat with base
-		a3hierarchyPoseConcat(currentHierarchyState->localPose,
-			poseSourceGroup->pose, poseBlendGroup->pose + 0,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// get matricies 
-		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// solve fk
-		a3kinematicsSolveForward(currentHierarchyState);
+		// shared evaluation
+		a3demo_evaluateClipCached(demoState, currentHierarchyState, clipCtrl0);
 
 		break;
 
@@ -1341,31 +1376,28 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl1 = demoState->ctrlCrouch;
 
 		// update both timelines
-		a3clipCtrlUpdate(clipCtrl0, (float)dt);
-		a3clipCtrlUpdate(clipCtrl1, (float)dt);
+		a3clipCtrlUpdate(clipCtrl0, dt);
+		a3clipCtrlUpdate(clipCtrl1, dt);
 
 		// lerping between current and next key pose
 		a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
 			poseSourceGroup->pose + clipCtrl0->frameIndex, poseSourceGroup->pose + clipCtrl0->nextIndex, clipCtrl0->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// yea yea
 		a3hierarchyPoseLERP(poseBlendGroup->pose + 1,
 			poseSourceGroup->pose + clipCtrl1->frameIndex, poseSourceGroup->pose + clipCtrl1->nextIndex, clipCtrl1->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// B L E N D
-		// choose operation and pass inputs from previous step
-		a3hierarchyPoseConcat(poseBlendGroup->pose + 2, poseBlendGroup->pose + 0, poseBlendGroup->pose + 1, demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// concat with base
-		a3hierarchyPoseConcat(currentHierarchyState->localPose,
-			poseSourceGroup->pose, poseBlendGroup->pose + 2,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+		// layer additive crouch on top of absolute clip (base already baked in)
+		a3hierarchyPoseAddLayer(currentHierarchyState->localPose,
+			poseBlendGroup->pose + 0, poseBlendGroup->pose + 1, 1.0f,
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// get matricies 
 		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// solve fk
 		a3kinematicsSolveForward(currentHierarchyState);
@@ -1378,31 +1410,28 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl1 = demoState->ctrlCrouch;
 
 		// update both timelines
-		a3clipCtrlUpdate(clipCtrl0, (float)dt);
-		a3clipCtrlUpdate(clipCtrl1, (float)dt);
+		a3clipCtrlUpdate(clipCtrl0, dt);
+		a3clipCtrlUpdate(clipCtrl1, dt);
 
 		// lerping between current and next key pose
 		a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
 			poseSourceGroup->pose + clipCtrl0->frameIndex, poseSourceGroup->pose + clipCtrl0->nextIndex, clipCtrl0->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// yea yea
 		a3hierarchyPoseLERP(poseBlendGroup->pose + 1,
 			poseSourceGroup->pose + clipCtrl1->frameIndex, poseSourceGroup->pose + clipCtrl1->nextIndex, clipCtrl1->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// B L E N D
-		// choose operation and pass inputs from previous step
-		a3hierarchyPoseConcat(poseBlendGroup->pose + 2, poseBlendGroup->pose + 0, poseBlendGroup->pose + 1, demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// concat with base
-		a3hierarchyPoseConcat(currentHierarchyState->localPose,
-			poseSourceGroup->pose, poseBlendGroup->pose + 2,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+		// layer additive crouch on top of absolute clip (base already baked in)
+		a3hierarchyPoseAddLayer(currentHierarchyState->localPose,
+			poseBlendGroup->pose + 0, poseBlendGroup->pose + 1, 1.0f,
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// get matricies 
 		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// solve fk
 		a3kinematicsSolveForward(currentHierarchyState);
@@ -1415,38 +1444,27 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl1 = demoState->ctrlCrouch;
 
 		// update both timelines
-		a3clipCtrlUpdate(clipCtrl0, (float)dt);
-		a3clipCtrlUpdate(clipCtrl1, (float)dt);
+		a3clipCtrlUpdate(clipCtrl0, dt);
+		a3clipCtrlUpdate(clipCtrl1, dt);
 
 		// lerping between current and next key pose
 		a3hierarchyPoseLERP(poseBlendGroup->pose + 0,
 			poseSourceGroup->pose + clipCtrl0->frameIndex, poseSourceGroup->pose + clipCtrl0->nextIndex, clipCtrl0->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// yea yea
 		a3hierarchyPoseLERP(poseBlendGroup->pose + 1,
 			poseSourceGroup->pose + clipCtrl1->frameIndex, poseSourceGroup->pose + clipCtrl1->nextIndex, clipCtrl1->frameParam,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
-		// weighted average concat
-		a3hierarchyPoseBlend(poseBlendGroup->pose + 2,
-			poseSourceGroup->pose + 0, poseBlendGroup->pose + 1,
-			.5f, .75f,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		a3hierarchyPoseLERP(poseBlendGroup->pose + 3,
-			poseBlendGroup->pose + 0, poseBlendGroup->pose + 2,
-			demoState->blendBeta,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
-
-		// concat with base
-		a3hierarchyPoseConcat(currentHierarchyState->localPose,
-			poseSourceGroup->pose, poseBlendGroup->pose + 3,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+		// fade in crouch layer (at most three quarters) on top of walk
+		a3hierarchyPoseAddLayer(currentHierarchyState->localPose,
+			poseBlendGroup->pose + 0, poseBlendGroup->pose + 1, .75f * demoState->blendBeta,
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// get matricies 
 		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
-			demoState->skeleton->numNodes, a3poseFlag_rotate | a3poseFlag_translate);
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
 
 		// solve fk
 		a3kinematicsSolveForward(currentHierarchyState);
@@ -1460,7 +1478,90 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 		clipCtrl2 = demoState->ctrlCrouch;
 
 		break;
+
+		// state machine
+	case 8:
+		a3animStatePlayerSetParam(demoState->skeletonStatePlayer, 0, demoState->blendBeta);
+		a3animStatePlayerUpdate(demoState->skeletonStatePlayer, dt);
+		a3animStatePlayerEvaluate(demoState->skeletonStatePlayer, demoState->skeletonPosePool, currentHierarchyState->localPose,
+			a3poseFlag_rotate_q | a3poseFlag_translate);
+
+		// get matricies 
+		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
+
+		// solve fk
+		a3kinematicsSolveForward(currentHierarchyState);
+
+		break;
+	}
+
+	// mode switched: decay from the last output into the new one instead 
+	//	of snapping (only the new mode is evaluated)
+	if (demoState->animationMode != demoState->animationModePrev)
+	{
+		a3inertializerBegin(demoState->skeletonInertializer, currentHierarchyState->localPose,
+			demoState->transitionDuration, dt, a3poseFlag_rotate_q | a3poseFlag_translate);
+		demoState->animationModePrev = demoState->animationMode;
+	}
+
+	// only re-solve if some nodes were corrected
+	if (a3inertializerApply(demoState->skeletonInertializer, currentHierarchyState->localPose, dt) > 0)
+	{
+		a3hierarchyPoseConvert(currentHierarchyState->localSpace, currentHierarchyState->localPose,
+			demoState->skeleton->numNodes, a3poseFlag_rotate_q | a3poseFlag_translate);
+		a3kinematicsSolveForward(currentHierarchyState);
+	}
+}
+
+void a3demo_update(a3_DemoState *demoState, double dt)
+{
+	a3_HierarchyState *publishState;
+	a3_BoneDisplay *publishDisplay;
+	p3mat4 modelViewProjectionMat;
+	unsigned int i;
+
+
+	// update scene objects
+	for (i = 0; i < demoStateMaxCount_sceneObject; ++i)
+		a3demo_updateSceneObject(demoState->sceneObject + i);
+
+	// update cameras
+	for (i = 0; i < demoStateMaxCount_camera; ++i)
+		a3demo_updateCameraViewProjection(demoState->camera + i);
+
+
+	// animation: run as many fixed ticks as have elapsed
+	//	(capped so a long stall does not snowball into more work)
+	demoState->animationTickTime += dt;
+	for (i = 0; i < demoStateMaxCount_animationTickPerUpdate && 
+		demoState->animationTickTime >= demoState->animationTickDuration; ++i)
+	{
+		// keep last result for display interpolation
+		a3hierarchyTransformCopy(demoState->skeletonState_prev->objectSpace, demoState->skeletonState_blend->objectSpace, 
+			demoState->skeleton->numNodes);
+		a3demo_updateAnimation(demoState, (float)demoState->animationTickDuration);
+		demoState->animationTickTime -= demoState->animationTickDuration;
 	}
+	if (demoState->animationTickTime >= demoState->animationTickDuration)
+		demoState->animationTickTime = demoState->animationTickDuration;
+	demoState->animationTickParam = (float)(demoState->animationTickTime * demoState->animationTickRate);
+
+	// publish display state: interpolated from previous to current tick
+	publishState = a3hierarchyStateBufferGetWrite(demoState->skeletonStateBuffer);
+	a3hierarchyPoseCopy(publishState->localPose, demoState->skeletonState_blend->localPose, 
+		demoState->skeleton->numNodes);
+	a3hierarchyTransformCopy(publishState->localSpace, demoState->skeletonState_blend->localSpace, 
+		demoState->skeleton->numNodes);
+	a3hierarchyTransformLERP(publishState->objectSpace, demoState->skeletonState_prev->objectSpace, demoState->skeletonState_blend->objectSpace, 
+		demoState->animationTickParam, demoState->skeleton->numNodes);
+	publishDisplay = demoState->skeletonDisplay + demoState->skeletonStateBuffer->writeIndex;
+	a3boneDisplayUpdate(publishDisplay, publishState->objectSpace);
+
+	// project joints once for labels (and anything else screen-space)
+	p3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, demoState->skeletonObject->modelMat.m);
+	a3boneDisplayProject(publishDisplay, &modelViewProjectionMat);
+	a3hierarchyStateBufferPublish(demoState->skeletonStateBuffer);
 
 	// update input
 	a3mouseUpdate(demoState->mouse);
@@ -1544,13 +1645,6 @@ void a3demo_render(const a3_DemoState *demoState)
 		+1.0f, 0.0f, 0.0f, 0.0f,
 		0.0f, 0.0f, 0.0f, +1.0f,
 	};
-	const p3mat4 downscale5x = {
-		0.2f, 0.0f, 0.0f, 0.0f,
-		0.0f, 0.2f, 0.0f, 0.0f,
-		0.0f, 0.0f, 0.2f, 0.0f,
-		0.0f, 0.0f, 0.0f, 1.0f,
-	};
-
 
 	// final model matrix and full matrix stack
 	p3mat4 modelMat = p3identityMat4, modelMatInv = p3identityMat4, modelViewProjectionMat = p3identityMat4;
@@ -1659,13 +1753,10 @@ void a3demo_render(const a3_DemoState *demoState)
 //	else
 	{
 		const a3_HierarchyState *currentHierarchyState;
+		const a3_BoneDisplay *currentDisplay;
 
-		// matrices for rendering bones relative to skeleton
-		p3mat4 boneMatrices[64], *boneMatrixPtr;
-
-		// temporary matrix pointers
-		const p3mat4 *nodeTransformPtr, *parentTransformPtr;
-		int parentIndex;
+		// joint matrices from the acquired display state
+		const p3mat4 *jointMatrices;
 
 		// tmp NDC vector for screen-space renders
 		p3vec4 posNDC;
@@ -1679,7 +1770,11 @@ void a3demo_render(const a3_DemoState *demoState)
 		currentDemoProgram = demoState->prog_drawColorUnifInstanced;
 		a3shaderProgramActivate(currentDemoProgram->program);
 
-		currentHierarchyState = demoState->skeletonState_blend;
+		// read only what was last acquired; update may already be writing 
+		//	the next state
+		currentHierarchyState = a3hierarchyStateBufferGetRead(demoState->skeletonStateBuffer);
+		currentDisplay = demoState->skeletonDisplay + demoState->skeletonStateBuffer->readIndex;
+		jointMatrices = currentHierarchyState->objectSpace->transform;
 	
 		// select state
 	//	switch (demoState->animationMode)
@@ -1698,51 +1793,22 @@ void a3demo_render(const a3_DemoState *demoState)
 		currentDrawable = demoState->draw_joint;
 		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, jointColor);
 		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uLocal,
-			currentHierarchyState->poseGroup->hierarchy->numNodes, (float *)currentHierarchyState->objectSpace->transform);
+			currentHierarchyState->poseGroup->hierarchy->numNodes, (float *)jointMatrices);
 		a3vertexActivateAndRenderDrawableInstanced(currentDrawable, currentHierarchyState->poseGroup->hierarchy->numNodes);
 
 		// draw bones
-		// first calculate their object-space orientations to make them appear to 
-		//	link joints together (it's a Frenet frame)
-		for (i = 0; i < currentHierarchyState->poseGroup->hierarchy->numNodes; ++i)
-		{
-			boneMatrixPtr = boneMatrices + i;
-			parentIndex = currentHierarchyState->poseGroup->hierarchy->nodes[i].parentIndex;
-			if (parentIndex >= 0)
-			{
-				nodeTransformPtr = currentHierarchyState->objectSpace->transform + i;
-				parentTransformPtr = currentHierarchyState->objectSpace->transform + parentIndex;
-
-				// reset
-				*boneMatrixPtr = p3identityMat4;
-
-				// set position
-				boneMatrixPtr->v3 = parentTransformPtr->v3;
-
-				// set direction column (local Z)
-				p3real4Diff(boneMatrixPtr->v2.v, nodeTransformPtr->v3.v, boneMatrixPtr->v3.v);
-
-				// set other basis vectors
-				p3real3CrossUnit(boneMatrixPtr->v0.v, (boneMatrixPtr->y2 != 0.0f ? p3zVec3.v : p3yVec3.v), boneMatrixPtr->v2.v);
-				p3real3CrossUnit(boneMatrixPtr->v1.v, boneMatrixPtr->v2.v, boneMatrixPtr->v0.v);
-			}
-			else
-				memset(boneMatrixPtr, 0, sizeof(p3mat4));
-		}
+		// their object-space orientations make them appear to link joints 
+		//	together (it's a Frenet frame); built in update with the state
 		currentDrawable = demoState->draw_bone;
 		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, boneColor);
 		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uLocal,
-			currentHierarchyState->poseGroup->hierarchy->numNodes, (float *)boneMatrices);
+			currentHierarchyState->poseGroup->hierarchy->numNodes, (float *)currentDisplay->boneTransform);
 		a3vertexActivateAndRenderDrawableInstanced(currentDrawable, currentHierarchyState->poseGroup->hierarchy->numNodes);
 
 
 		// draw overlays
 		if (demoState->displayBoneAxes || demoState->displayBoneNames)
 		{
-			// apply downscale to all bone matrices
-			for (i = 0; i < currentHierarchyState->poseGroup->hierarchy->numNodes; ++i)
-				p3real4x4Product(boneMatrices[i].m, currentHierarchyState->objectSpace->transform[i].m, downscale5x.m);
-
 			// draw small coordinate axes on bones to show 
 			//	their actual orientation
 			if (demoState->displayBoneAxes)
@@ -1753,7 +1819,7 @@ void a3demo_render(const a3_DemoState *demoState)
 				currentDrawable = demoState->draw_axes;
 				a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
 				a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uLocal,
-					currentHierarchyState->poseGroup->hierarchy->numNodes, (float *)boneMatrices);
+					currentHierarchyState->poseGroup->hierarchy->numNodes, (float *)currentDisplay->axesTransform);
 				a3vertexActivateAndRenderDrawableInstanced(currentDrawable, currentHierarchyState->poseGroup->hierarchy->numNodes);
 			}
 
@@ -1762,17 +1828,13 @@ void a3demo_render(const a3_DemoState *demoState)
 			{
 				a3shaderProgramDeactivate();
 
-				// concatenate bone matrices with MVP to get full transformation 
-				//	sequence for each joint
-				// get position of each joint in NDC, draw text using NDC position
+				// draw text at joint positions projected in update
 				for (i = 0; i < currentHierarchyState->poseGroup->hierarchy->numNodes; ++i)
 				{
-					p3real4x4ConcatR(modelViewProjectionMat.m, boneMatrices[i].m);
-					p3real4Real4x4Product(posNDC.v, boneMatrices[i].m, p3wVec4.v);
-					p3real4DivS(posNDC.v, posNDC.w);
-
-					a3textDraw(demoState->text, posNDC.x, posNDC.y, posNDC.z, 1.0f, 1.0f, 1.0f, 1.0f,
-						currentHierarchyState->poseGroup->hierarchy->nodes[i].name);
+					posNDC = currentDisplay->jointProjected[i];
+					if (posNDC.w > 0.0f)
+						a3textDraw(demoState->text, posNDC.x, posNDC.y, posNDC.z, 1.0f, 1.0f, 1.0f, 1.0f,
+							currentHierarchyState->poseGroup->hierarchy->nodes[i].name);
 				}
 			}
 		}
@@ -1821,6 +1883,7 @@ void a3demo_render(const a3_DemoState *demoState)
 			"Animation blending: walk + crouch",
 			"Animation blending: walk <--> walk + crouch",
 			"Animation blending: walk + wobble <--> walk + wobble + crouch",
+			"Animation state machine: idle <--> walk <--> walk + crouch",
 		};
 
 		glDisable(GL_DEPTH_TEST);
@@ -1874,6 +1937,15 @@ void a3demo_render(const a3_DemoState *demoState)
 			a3textDraw(demoState->text, -0.98f, +0.15f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
 				"    Blend param = %f", demoState->blendBeta);
 			break;
+			// state machine
+		case 8:
+			a3demo_drawClipCtrl(demoState->skeletonStatePlayer->ctrl, demoState->text, -0.98f, +0.80f);
+			a3textDraw(demoState->text, -0.98f, +0.55f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+				"    State = '%s';  fade = %f / %f", demoState->skeletonStateMachine->state[demoState->skeletonStatePlayer->stateIndex].name, 
+				demoState->skeletonStatePlayer->fadeTime, demoState->skeletonStatePlayer->fadeDuration);
+			a3textDraw(demoState->text, -0.98f, +0.50f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+				"    Blend param = %f", demoState->blendBeta);
+			break;
 		}
 
 		// display controls
@@ -43,8 +43,13 @@
 #include "_utilities/a3_RayPicking.h"
 #include "_utilities/a3_Quaternion.h"
 #include "_utilities/a3_HierarchyState.h"
+#include "_utilities/a3_HierarchyStateBuffer.h"
+#include "_utilities/a3_BoneDisplay.h"
 #include "_utilities/a3_Kinematics.h"
 #include "_utilities/a3_ClipControl.h"
+#include "_utilities/a3_PoseCache.h"
+#include "_utilities/a3_Inertializer.h"
+#include "_utilities/a3_AnimStateMachine.h"
 
 
 //-----------------------------------------------------------------------------
@@ -75,6 +80,7 @@ extern "C"
 		demoStateMaxCount_drawable = 16,
 		demoStateMaxCount_shaderProgram = 8,
 		demoStateMaxCount_shaderProgramUniform = 16,
+		demoStateMaxCount_animationTickPerUpdate = 4,
 	};
 
 
@@ -156,6 +162,9 @@ extern "C"
 
 		// update and display modes
 		int animationMode, animationModeCount;
+
+		// mode evaluated by the last tick, to detect switches
+		int animationModePrev;
 		int displayBoneAxes, displayBoneNames;
 
 		// skeleton hierarchy (resource)
@@ -170,6 +179,31 @@ extern "C"
 		// hierarchy states for different modes (not a resource)
 		a3_HierarchyState skeletonState_blend[1];
 
+		// result of the previous animation tick, kept for display 
+		//	interpolation (not a resource)
+		a3_HierarchyState skeletonState_prev[1];
+
+		// shared evaluations of single-clip states (not a resource)
+		a3_PoseCache skeletonPoseCache[1];
+
+		// decays the pose offset left by mode switches (not a resource)
+		a3_Inertializer skeletonInertializer[1];
+		float transitionDuration;
+
+		// state machine description, its player and the scratch poses 
+		//	used while evaluating it (not resources)
+		a3_AnimStateMachine skeletonStateMachine[1];
+		a3_AnimStatePlayer skeletonStatePlayer[1];
+		a3_HierarchyPosePool skeletonPosePool[1];
+
+		// display state published by update and acquired for render, so 
+		//	the two never touch the same matrices (not a resource)
+		a3_HierarchyStateBuffer skeletonStateBuffer[1];
+
+		// display transforms for each buffered state, built in update 
+		//	(indexed the same as the buffer's states; not a resource)
+		a3_BoneDisplay skeletonDisplay[3];
+
 		// clip group to divide up the poses
 		a3_ClipGroup skeletonClips[1];
 
@@ -179,6 +213,12 @@ extern "C"
 		// interpolation control
 		float blendBeta, targetBlendBeta, targetBlendBetaSmoothing;
 
+		// fixed-rate animation tick: animation runs zero or more times per 
+		//	update at a constant step; leftover time becomes the display 
+		//	interpolation param between the previous and current tick
+		double animationTickRate, animationTickDuration, animationTickTime;
+		float animationTickParam;
+
 
 		//---------------------------------------------------------------------
 		// object arrays: organized as anonymous unions for two reasons: 
@@ -234,6 +234,7 @@ A3API int a3test_idle(a3_DemoState *demoState)
 			// render timer ticked, update demo state and draw
 			a3demo_input(demoState, demoState->renderTimer->secondsPerTick);
 			a3demo_update(demoState, demoState->renderTimer->secondsPerTick);
+			a3hierarchyStateBufferAcquire(demoState->skeletonStateBuffer);
 			a3demo_render(demoState);
 
 			// render occurred this idle: return +1